@@ -26,6 +26,14 @@
 ** BINLOG CONFIG
 */
 #define SQLITE_DBCONFIG_ENABLE_BINLOG    2006 /* Sqlite3BinlogConfig */
+#define SQLITE_DBCONFIG_BINLOG_REPLAY_BATCH 2007 /* int nEvent, int nByte */
+#define SQLITE_DBCONFIG_BINLOG_WRITE_MODE 2008 /* int mode, int *pMode */
+#define SQLITE_DBCONFIG_BINLOG_WRITE_LAG  2009 /* int *pnEvent */
+#define SQLITE_DBCONFIG_BINLOG_SEARCH_ROWID 2010 /* sqlite3_int64 minRowid, sqlite3_int64 maxRowid */
+/* Write modes of SQLITE_DBCONFIG_BINLOG_WRITE_MODE */
+#define SQLITE_BINLOG_WRITE_SYNC  0 /* Events are written by the committing thread */
+#define SQLITE_BINLOG_WRITE_GROUP 1 /* Events are written by a writer thread, commit waits for them */
+#define SQLITE_BINLOG_WRITE_ASYNC 2 /* Events are written by a writer thread, commit does not wait */
 
 typedef enum BinlogFileCleanMode {
   BINLOG_FILE_CLEAN_ALL_MODE = 0,
@@ -89,6 +97,18 @@ typedef struct MonitorTablesConfig {
 /*
 ** END OF BINLOG CONFIG
 *************************************************************************/
+/*************************************************************************
+** COMPRESS CONFIG
+*/
+typedef enum CompressdbConvertMode {
+  COMPRESSDB_CONVERT_COMPRESS = 1,    /* Plain database to compressed database */
+  COMPRESSDB_CONVERT_DECOMPRESS = 2,  /* Compressed database to plain database */
+} CompressdbConvertModeE;
+
+typedef struct sqlite3_compressdb_convert sqlite3_compressdb_convert;
+/*
+** END OF COMPRESS CONFIG
+*************************************************************************/
 typedef struct {
   // aes-256-gcm, aes-256-cbc
   const void *pCipher;
@@ -108,6 +128,18 @@ typedef struct {
   CodecConfig rekeyCfg;
 } CodecRekeyConfig;
 
+typedef struct {
+  CodecConfig cfg;
+  // 1 to authenticate pages by the gcm tag, only for aes-256-gcm
+  int gcmTag;
+} CodecConfigV2;
+
+typedef struct {
+  const char *dbPath;
+  CodecConfigV2 dbCfg;
+  CodecConfigV2 rekeyCfg;
+} CodecRekeyConfigV2;
+
 struct sqlite3_api_routines_extra {
   int (*initialize)();
   int (*config)(int,...);
@@ -128,6 +160,11 @@ struct sqlite3_api_routines_extra {
   int (*reset_search_hwm)(sqlite3*);
   int (*clean_binlog)(sqlite3*, BinlogFileCleanModeE);
   int (*compressdb_backup)(sqlite3*, const char*);
+  sqlite3_compressdb_convert *(*compressdb_convert_init)(sqlite3*, const char*, CompressdbConvertModeE);
+  int (*compressdb_convert_step)(sqlite3_compressdb_convert*, int);
+  int (*compressdb_convert_remaining)(sqlite3_compressdb_convert*);
+  int (*compressdb_convert_finish)(sqlite3_compressdb_convert*);
+  int (*rekey_v4)(CodecRekeyConfigV2 *);
 };
 
 extern const struct sqlite3_api_routines_extra *sqlite3_export_extra_symbols;
@@ -150,6 +187,11 @@ extern const struct sqlite3_api_routines_extra *sqlite3_export_extra_symbols;
 #define sqlite3_reset_search_hwm_binlog sqlite3_export_extra_symbols->reset_search_hwm
 #define sqlite3_clean_binlog        sqlite3_export_extra_symbols->clean_binlog
 #define sqlite3_compressdb_backup   sqlite3_export_extra_symbols->compressdb_backup
+#define sqlite3_compressdb_convert_init       sqlite3_export_extra_symbols->compressdb_convert_init
+#define sqlite3_compressdb_convert_step       sqlite3_export_extra_symbols->compressdb_convert_step
+#define sqlite3_compressdb_convert_remaining  sqlite3_export_extra_symbols->compressdb_convert_remaining
+#define sqlite3_compressdb_convert_finish     sqlite3_export_extra_symbols->compressdb_convert_finish
+#define sqlite3_rekey_v4            sqlite3_export_extra_symbols->rekey_v4
 
 struct sqlite3_api_routines_cksumvfs {
   int (*register_cksumvfs)(const char *);
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "common.h"
+#include "sqlite3sym.h"
+
+using namespace testing::ext;
+using namespace UnitTest::SQLiteTest;
+
+#define TEST_DIR "./sqlitebinlogasynctest"
+#define TEST_DB (TEST_DIR "/test.db")
+#define TEST_BACKUP_DB (TEST_DIR "/test_bak.db")
+#define TEST_DATA_COUNT 1000
+#define TEST_DATA_REAL 16.1
+#define TEST_EXTRA_SIZE 512
+#define TEST_SEGMENT_SIZE (4 * 1024 * 1024)
+
+namespace BinlogAsyncTest {
+static void UtSqliteLogPrint(const void *data, int err, const char *msg)
+{
+    std::cout << "SqliteBinlogAsyncTest SQLite xLog err:" << err << ", msg:" << msg << std::endl;
+}
+
+static void UtPresetDb(const char *dbFile)
+{
+    sqlite3 *db = NULL;
+    EXPECT_EQ(sqlite3_open(dbFile, &db), SQLITE_OK);
+    static const char *UT_DDL_CREATE_TABLE = "CREATE TABLE salary("
+        "entryId INTEGER PRIMARY KEY,"
+        "entryName Text,"
+        "salary REAL,"
+        "class INTEGER,"
+        "extra BLOB);";
+    EXPECT_EQ(sqlite3_exec(db, UT_DDL_CREATE_TABLE, NULL, NULL, NULL), SQLITE_OK);
+    sqlite3_close(db);
+}
+
+static void UtEnableBinlog(sqlite3 *db)
+{
+    Sqlite3BinlogConfig cfg = {
+        .mode = Sqlite3BinlogMode::ROW,
+        .fullCallbackThreshold = 2,
+        .maxFileSize = TEST_SEGMENT_SIZE,
+        .xErrorCallback = nullptr,
+        .xLogFullCallback = nullptr,
+        .callbackCtx = nullptr,
+    };
+    EXPECT_EQ(sqlite3_db_config(db, SQLITE_DBCONFIG_ENABLE_BINLOG, &cfg), SQLITE_OK);
+}
+
+static sqlite3 *UtOpenDb(const char *dbFile)
+{
+    sqlite3 *db = NULL;
+    EXPECT_EQ(sqlite3_open_v2(dbFile, &db,
+        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr), SQLITE_OK);
+    return db;
+}
+
+static void UtInsertRecords(sqlite3 *db, int start, int count)
+{
+    static const char *UT_SQL_INSERT_DATA =
+        "INSERT INTO salary(entryId, entryName, salary, class, extra) VALUES(?,?,?,?,?);";
+    sqlite3_stmt *insertStmt = NULL;
+    EXPECT_EQ(sqlite3_prepare_v2(db, UT_SQL_INSERT_DATA, -1, &insertStmt, NULL), SQLITE_OK);
+    char extra[TEST_EXTRA_SIZE] = { 0 };
+    for (int i = start; i < start + count; i++) {
+        // bind parameters, 1, 2, 3, 4, 5 are sequence number of fields
+        sqlite3_bind_int(insertStmt, 1, i + 1);
+        sqlite3_bind_text(insertStmt, 2, "salary-entry-name", -1, SQLITE_STATIC);
+        sqlite3_bind_double(insertStmt, 3, TEST_DATA_REAL + i);
+        sqlite3_bind_int(insertStmt, 4, i + 1);
+        sqlite3_bind_blob(insertStmt, 5, extra, sizeof(extra), SQLITE_STATIC);
+        EXPECT_EQ(sqlite3_step(insertStmt), SQLITE_DONE);
+        sqlite3_reset(insertStmt);
+    }
+    sqlite3_finalize(insertStmt);
+}
+
+static int UtGetRecordCount(sqlite3 *db)
+{
+    sqlite3_stmt *stmt = NULL;
+    EXPECT_EQ(sqlite3_prepare_v2(db, "SELECT count(*) FROM salary;", -1, &stmt, NULL), SQLITE_OK);
+    EXPECT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    int count = sqlite3_column_int(stmt, 0);
+    sqlite3_finalize(stmt);
+    return count;
+}
+
+static int UtGetWriteMode(sqlite3 *db)
+{
+    int mode = -1;
+    EXPECT_EQ(sqlite3_db_config(db, SQLITE_DBCONFIG_BINLOG_WRITE_MODE, -1, &mode), SQLITE_OK);
+    return mode;
+}
+
+static int UtGetWriteLag(sqlite3 *db)
+{
+    int lag = -1;
+    EXPECT_EQ(sqlite3_db_config(db, SQLITE_DBCONFIG_BINLOG_WRITE_LAG, &lag), SQLITE_OK);
+    return lag;
+}
+
+class SqliteBinlogAsyncTest : public testing::Test {
+public:
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+};
+
+void SqliteBinlogAsyncTest::SetUpTestCase(void)
+{
+    Common::RemoveDir(TEST_DIR);
+    Common::MakeDir(TEST_DIR);
+}
+
+void SqliteBinlogAsyncTest::TearDownTestCase(void)
+{
+}
+
+void SqliteBinlogAsyncTest::SetUp(void)
+{
+    std::string command = "rm -rf ";
+    command += TEST_DIR "/*";
+    system(command.c_str());
+    sqlite3_config(SQLITE_CONFIG_LOG, &UtSqliteLogPrint, NULL);
+    UtPresetDb(TEST_DB);
+    UtPresetDb(TEST_BACKUP_DB);
+}
+
+void SqliteBinlogAsyncTest::TearDown(void)
+{
+    sqlite3_config(SQLITE_CONFIG_LOG, NULL, NULL);
+}
+
+/**
+ * @tc.name: BinlogAsyncTest001
+ * @tc.desc: Test get and set the binlog write mode
+ * @tc.type: FUNC
+ */
+HWTEST_F(SqliteBinlogAsyncTest, BinlogAsyncTest001, TestSize.Level0)
+{
+    /**
+     * @tc.steps: step1. open db and set binlog
+     * @tc.expected: step1. the events are written asynchronously by default, and nothing is queued
+     */
+    sqlite3 *db = UtOpenDb(TEST_DB);
+    ASSERT_NE(db, nullptr);
+    UtEnableBinlog(db);
+    EXPECT_EQ(UtGetWriteMode(db), SQLITE_BINLOG_WRITE_ASYNC);
+    EXPECT_EQ(UtGetWriteLag(db), 0);
+    /**
+     * @tc.steps: step2. set an invalid mode
+     * @tc.expected: step2. SQLITE_MISUSE, and the mode is not changed
+     */
+    int mode = -1;
+    EXPECT_EQ(sqlite3_db_config(db, SQLITE_DBCONFIG_BINLOG_WRITE_MODE, SQLITE_BINLOG_WRITE_ASYNC + 1, &mode),
+        SQLITE_MISUSE);
+    EXPECT_EQ(UtGetWriteMode(db), SQLITE_BINLOG_WRITE_ASYNC);
+    /**
+     * @tc.steps: step3. switch to every mode in turn
+     * @tc.expected: step3. the mode in effect is the one set
+     */
+    EXPECT_EQ(sqlite3_db_config(db, SQLITE_DBCONFIG_BINLOG_WRITE_MODE, SQLITE_BINLOG_WRITE_SYNC, &mode), SQLITE_OK);
+    EXPECT_EQ(mode, SQLITE_BINLOG_WRITE_SYNC);
+    EXPECT_EQ(sqlite3_db_config(db, SQLITE_DBCONFIG_BINLOG_WRITE_MODE, SQLITE_BINLOG_WRITE_GROUP, &mode), SQLITE_OK);
+    EXPECT_EQ(mode, SQLITE_BINLOG_WRITE_GROUP);
+    EXPECT_EQ(sqlite3_db_config(db, SQLITE_DBCONFIG_BINLOG_WRITE_MODE, SQLITE_BINLOG_WRITE_ASYNC, &mode), SQLITE_OK);
+    EXPECT_EQ(mode, SQLITE_BINLOG_WRITE_ASYNC);
+    sqlite3_close_v2(db);
+}
+
+/**
+ * @tc.name: BinlogAsyncTest002
+ * @tc.desc: Test replay the events queued by the async writer
+ * @tc.type: FUNC
+ */
+HWTEST_F(SqliteBinlogAsyncTest, BinlogAsyncTest002, TestSize.Level1)
+{
+    /**
+     * @tc.steps: step1. open db and set binlog, insert records in async mode
+     * @tc.expected: step1. Execute successfully, the lag never exceeds the records inserted
+     */
+    sqlite3 *db = UtOpenDb(TEST_DB);
+    ASSERT_NE(db, nullptr);
+    UtEnableBinlog(db);
+    UtInsertRecords(db, 0, TEST_DATA_COUNT);
+    int lag = UtGetWriteLag(db);
+    EXPECT_GE(lag, 0);
+    // every autocommit insert is at most 4 events, start, table, row and commit
+    EXPECT_LE(lag, TEST_DATA_COUNT * 4);
+    /**
+     * @tc.steps: step2. binlog replay to write into backup db
+     * @tc.expected: step2. Return SQLITE_OK, the queue is drained before the binlog is read, so every record is
+     *     replayed
+     */
+    sqlite3 *backupDb = UtOpenDb(TEST_BACKUP_DB);
+    ASSERT_NE(backupDb, nullptr);
+    EXPECT_EQ(sqlite3_replay_binlog(db, backupDb), SQLITE_OK);
+    EXPECT_EQ(UtGetWriteLag(db), 0);
+    EXPECT_EQ(UtGetRecordCount(backupDb), TEST_DATA_COUNT);
+    sqlite3_close_v2(db);
+    sqlite3_close_v2(backupDb);
+}
+
+/**
+ * @tc.name: BinlogAsyncTest003
+ * @tc.desc: Test group mode waits for the events of a transaction at its commit
+ * @tc.type: FUNC
+ */
+HWTEST_F(SqliteBinlogAsyncTest, BinlogAsyncTest003, TestSize.Level1)
+{
+    /**
+     * @tc.steps: step1. open db and set binlog in group mode
+     * @tc.expected: step1. ok
+     */
+    sqlite3 *db = UtOpenDb(TEST_DB);
+    ASSERT_NE(db, nullptr);
+    UtEnableBinlog(db);
+    int mode = -1;
+    EXPECT_EQ(sqlite3_db_config(db, SQLITE_DBCONFIG_BINLOG_WRITE_MODE, SQLITE_BINLOG_WRITE_GROUP, &mode), SQLITE_OK);
+    EXPECT_EQ(mode, SQLITE_BINLOG_WRITE_GROUP);
+    /**
+     * @tc.steps: step2. Insert records in autocommit mode and in an explicit transaction
+     * @tc.expected: step2. nothing is left queued once a transaction is committed
+     */
+    UtInsertRecords(db, 0, TEST_DATA_COUNT / 2);
+    EXPECT_EQ(UtGetWriteLag(db), 0);
+    EXPECT_EQ(sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr), SQLITE_OK);
+    UtInsertRecords(db, TEST_DATA_COUNT / 2, TEST_DATA_COUNT / 2);
+    EXPECT_EQ(sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(UtGetWriteLag(db), 0);
+    /**
+     * @tc.steps: step3. close db with the binlog, then reopen it and replay to write into backup db
+     * @tc.expected: step3. Return SQLITE_OK, every record is replayed
+     */
+    sqlite3_close_v2(db);
+    db = UtOpenDb(TEST_DB);
+    ASSERT_NE(db, nullptr);
+    UtEnableBinlog(db);
+    sqlite3 *backupDb = UtOpenDb(TEST_BACKUP_DB);
+    ASSERT_NE(backupDb, nullptr);
+    EXPECT_EQ(sqlite3_replay_binlog(db, backupDb), SQLITE_OK);
+    EXPECT_EQ(UtGetRecordCount(backupDb), TEST_DATA_COUNT);
+    sqlite3_close_v2(db);
+    sqlite3_close_v2(backupDb);
+}
+}  // namespace BinlogAsyncTest
@@ -0,0 +1,624 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+#include "common.h"
+#include "sqlite3sym.h"
+
+using namespace testing::ext;
+using namespace UnitTest::SQLiteTest;
+
+#define TEST_DIR "./sqlitebinloglocaltest"
+#define TEST_DB (TEST_DIR "/test.db")
+#define TEST_BACKUP_DB (TEST_DIR "/test_bak.db")
+#define TEST_DATA_COUNT 1000
+#define TEST_DATA_REAL 16.1
+#define TEST_EXTRA_SIZE 512
+#define TEST_SEGMENT_SIZE (64 * 1024)
+#define TEST_SEGMENT_MAX 4096
+
+namespace BinlogLocalTest {
+static int g_logFullCount = 0;
+static unsigned short g_logFullFiles = 0;
+
+static void UtSqliteLogPrint(const void *data, int err, const char *msg)
+{
+    std::cout << "SqliteBinlogLocalTest SQLite xLog err:" << err << ", msg:" << msg << std::endl;
+}
+
+static void UtLogFullCallback(void *pCtx, unsigned short currentCount, const char *dbPath)
+{
+    g_logFullCount++;
+    g_logFullFiles = currentCount;
+}
+
+static void UtPresetDb(const char *dbFile)
+{
+    sqlite3 *db = NULL;
+    EXPECT_EQ(sqlite3_open(dbFile, &db), SQLITE_OK);
+    static const char *UT_DDL_CREATE_TABLE = "CREATE TABLE salary("
+        "entryId INTEGER PRIMARY KEY,"
+        "entryName Text,"
+        "salary REAL,"
+        "class INTEGER,"
+        "extra BLOB);";
+    EXPECT_EQ(sqlite3_exec(db, UT_DDL_CREATE_TABLE, NULL, NULL, NULL), SQLITE_OK);
+    sqlite3_close(db);
+}
+
+static void UtEnableBinlog(sqlite3 *db, Sqlite3BinlogMode mode, unsigned int maxFileSize)
+{
+    Sqlite3BinlogConfig cfg = {
+        .mode = mode,
+        .fullCallbackThreshold = 2,
+        .maxFileSize = maxFileSize,
+        .xErrorCallback = nullptr,
+        .xLogFullCallback = UtLogFullCallback,
+        .callbackCtx = nullptr,
+    };
+    EXPECT_EQ(sqlite3_db_config(db, SQLITE_DBCONFIG_ENABLE_BINLOG, &cfg), SQLITE_OK);
+}
+
+static sqlite3 *UtOpenDb(const char *dbFile)
+{
+    sqlite3 *db = NULL;
+    EXPECT_EQ(sqlite3_open_v2(dbFile, &db,
+        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr), SQLITE_OK);
+    return db;
+}
+
+static void UtInsertRecords(sqlite3 *db, int start, int count)
+{
+    static const char *UT_SQL_INSERT_DATA =
+        "INSERT INTO salary(entryId, entryName, salary, class, extra) VALUES(?,?,?,?,?);";
+    sqlite3_stmt *insertStmt = NULL;
+    EXPECT_EQ(sqlite3_prepare_v2(db, UT_SQL_INSERT_DATA, -1, &insertStmt, NULL), SQLITE_OK);
+    char extra[TEST_EXTRA_SIZE] = { 0 };
+    for (int i = start; i < start + count; i++) {
+        // bind parameters, 1, 2, 3, 4, 5 are sequence number of fields
+        sqlite3_bind_int(insertStmt, 1, i + 1);
+        sqlite3_bind_text(insertStmt, 2, "salary-entry-name", -1, SQLITE_STATIC);
+        sqlite3_bind_double(insertStmt, 3, TEST_DATA_REAL + i);
+        sqlite3_bind_int(insertStmt, 4, i + 1);
+        sqlite3_bind_blob(insertStmt, 5, extra, sizeof(extra), SQLITE_STATIC);
+        EXPECT_EQ(sqlite3_step(insertStmt), SQLITE_DONE);
+        sqlite3_reset(insertStmt);
+    }
+    sqlite3_finalize(insertStmt);
+}
+
+static int UtGetRecordCount(sqlite3 *db)
+{
+    sqlite3_stmt *stmt = NULL;
+    EXPECT_EQ(sqlite3_prepare_v2(db, "SELECT count(*) FROM salary;", -1, &stmt, NULL), SQLITE_OK);
+    EXPECT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    int count = sqlite3_column_int(stmt, 0);
+    sqlite3_finalize(stmt);
+    return count;
+}
+
+static std::string UtSegmentPath(int index)
+{
+    return std::string(TEST_DB) + "-binlog." + std::to_string(index);
+}
+
+/* Returns the index of the newest segment file, -1 if there is none */
+static int UtLastSegment()
+{
+    int last = -1;
+    for (int i = 0; i < TEST_SEGMENT_MAX; i++) {
+        if (Common::IsFileExist(UtSegmentPath(i).c_str())) {
+            last = i;
+        }
+    }
+    return last;
+}
+
+static int UtSegmentCount()
+{
+    int count = 0;
+    for (int i = 0; i < TEST_SEGMENT_MAX; i++) {
+        if (Common::IsFileExist(UtSegmentPath(i).c_str())) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static MonitorTablesConfig *InitMonitorConfig(const char *tableName)
+{
+    MonitorTablesConfig *monitorConfig = static_cast<MonitorTablesConfig*>(malloc(sizeof(MonitorTablesConfig)));
+    memset_s(monitorConfig, sizeof(MonitorTablesConfig), 0, sizeof(MonitorTablesConfig));
+    int defaultSize = 10;
+    monitorConfig->tables = static_cast<MonitorTableCol*>(malloc(defaultSize * sizeof(MonitorTableCol)));
+    memset_s(monitorConfig->tables, defaultSize * sizeof(MonitorTableCol), 0, defaultSize * sizeof(MonitorTableCol));
+    monitorConfig->tables[0].tableName = strdup(tableName);
+    monitorConfig->tableCount++;
+    monitorConfig->tables[0].colCount = 1;
+    monitorConfig->tables[0].cols = static_cast<char**>(malloc(sizeof(char*) * defaultSize)); // default 10 cols
+    monitorConfig->tables[0].cols[0] = strdup("id");
+    return monitorConfig;
+}
+
+/* Search returns SQLITE_DONE once it reaches the end of the binlog */
+static int UtSearch(sqlite3 *readDb, sqlite3 *backupDb, BinlogSearchResultSet **rs)
+{
+    int rc = sqlite3_get_search_data_binlog(readDb, backupDb, rs);
+    EXPECT_TRUE(rc == SQLITE_OK || rc == SQLITE_DONE);
+    return rc;
+}
+
+static int UtGetSearchCount(sqlite3 *readDb, sqlite3 *backupDb)
+{
+    BinlogSearchResultSet *rs = nullptr;
+    UtSearch(readDb, backupDb, &rs);
+    if (rs == nullptr) {
+        return 0;
+    }
+    int count = rs->row_count;
+    EXPECT_EQ(sqlite3_free_search_data_binlog(readDb, &rs), SQLITE_OK);
+    return count;
+}
+
+class SqliteBinlogLocalTest : public testing::Test {
+public:
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+};
+
+void SqliteBinlogLocalTest::SetUpTestCase(void)
+{
+    Common::RemoveDir(TEST_DIR);
+    Common::MakeDir(TEST_DIR);
+}
+
+void SqliteBinlogLocalTest::TearDownTestCase(void)
+{
+}
+
+void SqliteBinlogLocalTest::SetUp(void)
+{
+    std::string command = "rm -rf ";
+    command += TEST_DIR "/*";
+    system(command.c_str());
+    sqlite3_config(SQLITE_CONFIG_LOG, &UtSqliteLogPrint, NULL);
+    UtPresetDb(TEST_DB);
+    UtPresetDb(TEST_BACKUP_DB);
+    g_logFullCount = 0;
+    g_logFullFiles = 0;
+}
+
+void SqliteBinlogLocalTest::TearDown(void)
+{
+    sqlite3_config(SQLITE_CONFIG_LOG, NULL, NULL);
+}
+
+/**
+ * @tc.name: BinlogLocalTest001
+ * @tc.desc: Test segment rotation at maxFileSize and the log full callback
+ * @tc.type: FUNC
+ */
+HWTEST_F(SqliteBinlogLocalTest, BinlogLocalTest001, TestSize.Level0)
+{
+    /**
+     * @tc.steps: step1. open db and set binlog with small segments
+     * @tc.expected: step1. ok
+     */
+    sqlite3 *db = UtOpenDb(TEST_DB);
+    ASSERT_NE(db, nullptr);
+    UtEnableBinlog(db, Sqlite3BinlogMode::ROW, TEST_SEGMENT_SIZE);
+    /**
+     * @tc.steps: step2. Insert records much larger than one segment
+     * @tc.expected: step2. several segments are written, none of them exceeds maxFileSize
+     */
+    UtInsertRecords(db, 0, TEST_DATA_COUNT);
+    int lastSegment = UtLastSegment();
+    EXPECT_GT(lastSegment, 1);
+    EXPECT_EQ(UtSegmentCount(), lastSegment + 1);
+    for (int i = 0; i <= lastSegment; i++) {
+        struct stat sStat;
+        ASSERT_EQ(stat(UtSegmentPath(i).c_str(), &sStat), 0);
+        EXPECT_LE(sStat.st_size, TEST_SEGMENT_SIZE);
+    }
+    /**
+     * @tc.steps: step3. check the log full callback
+     * @tc.expected: step3. called once the threshold of 2 files is reached, with the current file count
+     */
+    EXPECT_GT(g_logFullCount, 0);
+    EXPECT_EQ(g_logFullFiles, lastSegment + 1);
+    /**
+     * @tc.steps: step4. binlog replay to write into backup db
+     * @tc.expected: step4. Return SQLITE_OK, the events of every segment are replayed
+     */
+    sqlite3 *backupDb = UtOpenDb(TEST_BACKUP_DB);
+    ASSERT_NE(backupDb, nullptr);
+    EXPECT_EQ(sqlite3_replay_binlog(db, backupDb), SQLITE_OK);
+    EXPECT_EQ(UtGetRecordCount(backupDb), TEST_DATA_COUNT);
+    sqlite3_close_v2(db);
+    sqlite3_close_v2(backupDb);
+}
+
+/**
+ * @tc.name: BinlogLocalTest002
+ * @tc.desc: Test the torn event left at the end of the last segment is dropped when the binlog is opened again
+ * @tc.type: FUNC
+ */
+HWTEST_F(SqliteBinlogLocalTest, BinlogLocalTest002, TestSize.Level1)
+{
+    /**
+     * @tc.steps: step1. open db and set binlog, insert records and close db
+     * @tc.expected: step1. ok
+     */
+    sqlite3 *db = UtOpenDb(TEST_DB);
+    ASSERT_NE(db, nullptr);
+    UtEnableBinlog(db, Sqlite3BinlogMode::ROW, TEST_SEGMENT_SIZE);
+    UtInsertRecords(db, 0, TEST_DATA_COUNT / 2);
+    sqlite3_close_v2(db);
+    /**
+     * @tc.steps: step2. append a torn event to the last segment, as left by a crash in the middle of a write
+     * @tc.expected: step2. ok
+     */
+    int lastSegment = UtLastSegment();
+    ASSERT_GE(lastSegment, 0);
+    std::string lastPath = UtSegmentPath(lastSegment);
+    struct stat sStat;
+    ASSERT_EQ(stat(lastPath.c_str(), &sStat), 0);
+    off_t goodSize = sStat.st_size;
+    FILE *fp = fopen(lastPath.c_str(), "ab");
+    ASSERT_NE(fp, nullptr);
+    char garbage[TEST_EXTRA_SIZE];
+    memset_s(garbage, sizeof(garbage), 0x5a, sizeof(garbage));
+    EXPECT_EQ(fwrite(garbage, 1, sizeof(garbage), fp), sizeof(garbage));
+    fclose(fp);
+    /**
+     * @tc.steps: step3. open db again and insert more records
+     * @tc.expected: step3. the torn event is truncated before the new events are appended
+     */
+    db = UtOpenDb(TEST_DB);
+    ASSERT_NE(db, nullptr);
+    UtEnableBinlog(db, Sqlite3BinlogMode::ROW, TEST_SEGMENT_SIZE);
+    UtInsertRecords(db, TEST_DATA_COUNT / 2, TEST_DATA_COUNT / 2);
+    if (UtLastSegment() != lastSegment) {
+        ASSERT_EQ(stat(lastPath.c_str(), &sStat), 0);
+        EXPECT_EQ(sStat.st_size, goodSize);
+    }
+    /**
+     * @tc.steps: step4. binlog replay to write into backup db
+     * @tc.expected: step4. Return SQLITE_OK, the records written before and after the crash are all replayed
+     */
+    sqlite3 *backupDb = UtOpenDb(TEST_BACKUP_DB);
+    ASSERT_NE(backupDb, nullptr);
+    EXPECT_EQ(sqlite3_replay_binlog(db, backupDb), SQLITE_OK);
+    EXPECT_EQ(UtGetRecordCount(backupDb), TEST_DATA_COUNT);
+    sqlite3_close_v2(db);
+    sqlite3_close_v2(backupDb);
+}
+
+/**
+ * @tc.name: BinlogLocalTest003
+ * @tc.desc: Test a failed replay does not move the replay position, so a retry applies the same events
+ * @tc.type: FUNC
+ */
+HWTEST_F(SqliteBinlogLocalTest, BinlogLocalTest003, TestSize.Level1)
+{
+    /**
+     * @tc.steps: step1. open db and set binlog, insert records
+     * @tc.expected: step1. ok
+     */
+    sqlite3 *db = UtOpenDb(TEST_DB);
+    ASSERT_NE(db, nullptr);
+    UtEnableBinlog(db, Sqlite3BinlogMode::ROW, TEST_SEGMENT_SIZE);
+    UtInsertRecords(db, 0, TEST_DATA_COUNT);
+    /**
+     * @tc.steps: step2. binlog replay to a readonly backup db
+     * @tc.expected: step2. replay fails and binlog of db is closed
+     */
+    sqlite3 *backupDb = NULL;
+    EXPECT_EQ(sqlite3_open_v2(TEST_BACKUP_DB, &backupDb, SQLITE_OPEN_READONLY | SQLITE_OPEN_FULLMUTEX, nullptr),
+        SQLITE_OK);
+    ASSERT_NE(backupDb, nullptr);
+    EXPECT_NE(sqlite3_replay_binlog(db, backupDb), SQLITE_OK);
+    sqlite3_close_v2(backupDb);
+    /**
+     * @tc.steps: step3. set binlog again, then replay to a writable backup db
+     * @tc.expected: step3. Return SQLITE_OK, no record is lost
+     */
+    UtEnableBinlog(db, Sqlite3BinlogMode::ROW, TEST_SEGMENT_SIZE);
+    backupDb = UtOpenDb(TEST_BACKUP_DB);
+    ASSERT_NE(backupDb, nullptr);
+    EXPECT_EQ(sqlite3_replay_binlog(db, backupDb), SQLITE_OK);
+    EXPECT_EQ(UtGetRecordCount(backupDb), TEST_DATA_COUNT);
+    sqlite3_close_v2(db);
+    sqlite3_close_v2(backupDb);
+}
+
+/**
+ * @tc.name: BinlogLocalTest004
+ * @tc.desc: Test clean binlog in read mode only removes the segments already replayed
+ * @tc.type: FUNC
+ */
+HWTEST_F(SqliteBinlogLocalTest, BinlogLocalTest004, TestSize.Level1)
+{
+    /**
+     * @tc.steps: step1. open db and set binlog, insert records over several segments
+     * @tc.expected: step1. ok
+     */
+    sqlite3 *db = UtOpenDb(TEST_DB);
+    ASSERT_NE(db, nullptr);
+    UtEnableBinlog(db, Sqlite3BinlogMode::ROW, TEST_SEGMENT_SIZE);
+    UtInsertRecords(db, 0, TEST_DATA_COUNT);
+    int lastSegment = UtLastSegment();
+    EXPECT_GT(lastSegment, 1);
+    /**
+     * @tc.steps: step2. clean in read mode before any replay
+     * @tc.expected: step2. Return SQLITE_OK, no segment is removed
+     */
+    EXPECT_EQ(sqlite3_clean_binlog(db, BinlogFileCleanModeE::BINLOG_FILE_CLEAN_READ_MODE), SQLITE_OK);
+    EXPECT_EQ(UtSegmentCount(), lastSegment + 1);
+    /**
+     * @tc.steps: step3. replay, then clean in read mode
+     * @tc.expected: step3. the replayed segments are removed, the one being written is kept
+     */
+    sqlite3 *backupDb = UtOpenDb(TEST_BACKUP_DB);
+    ASSERT_NE(backupDb, nullptr);
+    EXPECT_EQ(sqlite3_replay_binlog(db, backupDb), SQLITE_OK);
+    EXPECT_EQ(sqlite3_clean_binlog(db, BinlogFileCleanModeE::BINLOG_FILE_CLEAN_READ_MODE), SQLITE_OK);
+    EXPECT_FALSE(Common::IsFileExist(UtSegmentPath(0).c_str()));
+    EXPECT_TRUE(Common::IsFileExist(UtSegmentPath(lastSegment).c_str()));
+    /**
+     * @tc.steps: step4. insert more records and replay
+     * @tc.expected: step4. Return SQLITE_OK, only the new records are replayed on top of the old ones
+     */
+    UtInsertRecords(db, TEST_DATA_COUNT, TEST_DATA_COUNT);
+    EXPECT_EQ(sqlite3_replay_binlog(db, backupDb), SQLITE_OK);
+    EXPECT_EQ(UtGetRecordCount(backupDb), TEST_DATA_COUNT * 2);
+    sqlite3_close_v2(db);
+    sqlite3_close_v2(backupDb);
+}
+
+/**
+ * @tc.name: BinlogLocalTest005
+ * @tc.desc: Test clean binlog in all mode removes every segment, replayed or not
+ * @tc.type: FUNC
+ */
+HWTEST_F(SqliteBinlogLocalTest, BinlogLocalTest005, TestSize.Level1)
+{
+    /**
+     * @tc.steps: step1. open db and set binlog, insert records over several segments
+     * @tc.expected: step1. ok
+     */
+    sqlite3 *db = UtOpenDb(TEST_DB);
+    ASSERT_NE(db, nullptr);
+    UtEnableBinlog(db, Sqlite3BinlogMode::ROW, TEST_SEGMENT_SIZE);
+    UtInsertRecords(db, 0, TEST_DATA_COUNT);
+    int lastSegment = UtLastSegment();
+    EXPECT_GT(lastSegment, 1);
+    /**
+     * @tc.steps: step2. clean in all mode
+     * @tc.expected: step2. Return SQLITE_OK, every segment written is removed
+     */
+    EXPECT_EQ(sqlite3_clean_binlog(db, BinlogFileCleanModeE::BINLOG_FILE_CLEAN_ALL_MODE), SQLITE_OK);
+    for (int i = 0; i <= lastSegment; i++) {
+        EXPECT_FALSE(Common::IsFileExist(UtSegmentPath(i).c_str()));
+    }
+    /**
+     * @tc.steps: step3. insert more records and replay
+     * @tc.expected: step3. Return SQLITE_OK, only the records written after the clean are replayed
+     */
+    UtInsertRecords(db, TEST_DATA_COUNT, TEST_DATA_COUNT / 2);
+    EXPECT_GT(UtLastSegment(), lastSegment);
+    sqlite3 *backupDb = UtOpenDb(TEST_BACKUP_DB);
+    ASSERT_NE(backupDb, nullptr);
+    EXPECT_EQ(sqlite3_replay_binlog(db, backupDb), SQLITE_OK);
+    EXPECT_EQ(UtGetRecordCount(backupDb), TEST_DATA_COUNT / 2);
+    sqlite3_close_v2(db);
+    sqlite3_close_v2(backupDb);
+}
+
+/**
+ * @tc.name: BinlogLocalTest006
+ * @tc.desc: Test set search hwm in persist mode survives reopen, and reset search hwm reads from the start again
+ * @tc.type: FUNC
+ */
+HWTEST_F(SqliteBinlogLocalTest, BinlogLocalTest006, TestSize.Level1)
+{
+    /**
+     * @tc.steps: step1. open the write db for search and the read db, create table and insert data
+     * @tc.expected: step1. ok
+     */
+    sqlite3 *writeDb = UtOpenDb(TEST_DB);
+    ASSERT_NE(writeDb, nullptr);
+    UtEnableBinlog(writeDb, Sqlite3BinlogMode::ROW_FOR_SEARCH, TEST_SEGMENT_SIZE);
+    EXPECT_EQ(sqlite3_set_json_parse_callback_binlog(writeDb, [] (const char *dbPath) -> MonitorTablesConfig *{
+        return InitMonitorConfig("test_hwm");
+    }), SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(writeDb, "create table test_hwm (id int primary key, name text);",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(writeDb, "insert into test_hwm values (1, 'First'), (2, 'Second'), (3, 'Third');",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3 *readDb = UtOpenDb(TEST_DB);
+    ASSERT_NE(readDb, nullptr);
+    UtEnableBinlog(readDb, Sqlite3BinlogMode::READ_FOR_SEARCH, TEST_SEGMENT_SIZE);
+    sqlite3 *backupDb = UtOpenDb(TEST_BACKUP_DB);
+    ASSERT_NE(backupDb, nullptr);
+    /**
+     * @tc.steps: step2. search, then search again
+     * @tc.expected: step2. all 3 records at first, none the second time
+     */
+    BinlogSearchResultSet *rs = nullptr;
+    UtSearch(readDb, backupDb, &rs);
+    ASSERT_NE(rs, nullptr);
+    EXPECT_EQ(rs->row_count, 3);
+    BinlogSearchHwmT hwm = {
+        .readFileIndex = rs->results[rs->row_count - 1].fileIndex,
+        .readPos = rs->results[rs->row_count - 1].readPos
+    };
+    EXPECT_EQ(sqlite3_free_search_data_binlog(readDb, &rs), SQLITE_OK);
+    EXPECT_EQ(UtGetSearchCount(readDb, backupDb), 0);
+    /**
+     * @tc.steps: step3. reopen the read db without a persisted hwm
+     * @tc.expected: step3. all 3 records are searched again
+     */
+    sqlite3_close_v2(readDb);
+    readDb = UtOpenDb(TEST_DB);
+    ASSERT_NE(readDb, nullptr);
+    UtEnableBinlog(readDb, Sqlite3BinlogMode::READ_FOR_SEARCH, TEST_SEGMENT_SIZE);
+    EXPECT_EQ(UtGetSearchCount(readDb, backupDb), 3);
+    /**
+     * @tc.steps: step4. persist the hwm after the last record, then reopen the read db
+     * @tc.expected: step4. nothing is searched
+     */
+    EXPECT_EQ(sqlite3_set_search_hwm_binlog(readDb, &hwm, BINLOG_PERSIST_MODE), SQLITE_OK);
+    sqlite3_close_v2(readDb);
+    readDb = UtOpenDb(TEST_DB);
+    ASSERT_NE(readDb, nullptr);
+    UtEnableBinlog(readDb, Sqlite3BinlogMode::READ_FOR_SEARCH, TEST_SEGMENT_SIZE);
+    EXPECT_EQ(UtGetSearchCount(readDb, backupDb), 0);
+    /**
+     * @tc.steps: step5. reset search hwm
+     * @tc.expected: step5. all 3 records are searched again
+     */
+    EXPECT_EQ(sqlite3_reset_search_hwm_binlog(readDb), SQLITE_OK);
+    EXPECT_EQ(UtGetSearchCount(readDb, backupDb), 3);
+    sqlite3_close_v2(readDb);
+    sqlite3_close_v2(writeDb);
+    sqlite3_close_v2(backupDb);
+}
+
+/**
+ * @tc.name: BinlogLocalTest007
+ * @tc.desc: Test search of one table skips the rows of the other tables by the segment index
+ * @tc.type: FUNC
+ */
+HWTEST_F(SqliteBinlogLocalTest, BinlogLocalTest007, TestSize.Level1)
+{
+    /**
+     * @tc.steps: step1. open the write db for search, write rows to two tables in turn
+     * @tc.expected: step1. ok, the segment has an index
+     */
+    sqlite3 *writeDb = UtOpenDb(TEST_DB);
+    ASSERT_NE(writeDb, nullptr);
+    UtEnableBinlog(writeDb, Sqlite3BinlogMode::ROW_FOR_SEARCH, TEST_SEGMENT_SIZE);
+    EXPECT_EQ(sqlite3_exec(writeDb, "create table test_a (id integer primary key, name text);"
+        "create table test_b (id integer primary key, name text);", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(writeDb, "insert into test_a values (1, 'a1'), (2, 'a2'), (3, 'a3');"
+        "insert into test_b values (1, 'b1'), (2, 'b2');"
+        "insert into test_a values (4, 'a4'), (5, 'a5');"
+        "insert into test_b values (3, 'b3');", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_TRUE(Common::IsFileExist((UtSegmentPath(UtLastSegment()) + ".idx").c_str()));
+    sqlite3 *readDb = UtOpenDb(TEST_DB);
+    ASSERT_NE(readDb, nullptr);
+    UtEnableBinlog(readDb, Sqlite3BinlogMode::READ_FOR_SEARCH, TEST_SEGMENT_SIZE);
+    sqlite3 *backupDb = UtOpenDb(TEST_BACKUP_DB);
+    ASSERT_NE(backupDb, nullptr);
+    /**
+     * @tc.steps: step2. search test_a only
+     * @tc.expected: step2. the 5 records of test_a and none of test_b
+     */
+    EXPECT_EQ(sqlite3_set_monitor_config_binlog(readDb, InitMonitorConfig("test_a")), SQLITE_OK);
+    BinlogSearchResultSet *rs = nullptr;
+    UtSearch(readDb, backupDb, &rs);
+    ASSERT_NE(rs, nullptr);
+    EXPECT_EQ(rs->row_count, 5);
+    for (int i = 0; i < rs->row_count; i++) {
+        EXPECT_STREQ(rs->results[i].tableName, "test_a");
+        EXPECT_EQ(rs->results[i].rowid, i + 1);
+    }
+    EXPECT_EQ(sqlite3_free_search_data_binlog(readDb, &rs), SQLITE_OK);
+    /**
+     * @tc.steps: step3. search test_b only from the start again
+     * @tc.expected: step3. the 3 records of test_b and none of test_a
+     */
+    EXPECT_EQ(sqlite3_set_monitor_config_binlog(readDb, InitMonitorConfig("test_b")), SQLITE_OK);
+    EXPECT_EQ(sqlite3_reset_search_hwm_binlog(readDb), SQLITE_OK);
+    UtSearch(readDb, backupDb, &rs);
+    ASSERT_NE(rs, nullptr);
+    EXPECT_EQ(rs->row_count, 3);
+    for (int i = 0; i < rs->row_count; i++) {
+        EXPECT_STREQ(rs->results[i].tableName, "test_b");
+    }
+    EXPECT_EQ(sqlite3_free_search_data_binlog(readDb, &rs), SQLITE_OK);
+    sqlite3_close_v2(readDb);
+    sqlite3_close_v2(writeDb);
+    sqlite3_close_v2(backupDb);
+}
+
+/**
+ * @tc.name: BinlogLocalTest008
+ * @tc.desc: Test search rowid filter
+ * @tc.type: FUNC
+ */
+HWTEST_F(SqliteBinlogLocalTest, BinlogLocalTest008, TestSize.Level1)
+{
+    /**
+     * @tc.steps: step1. open the write db for search, insert 10 rows with rowid 1 to 10
+     * @tc.expected: step1. ok
+     */
+    sqlite3 *writeDb = UtOpenDb(TEST_DB);
+    ASSERT_NE(writeDb, nullptr);
+    UtEnableBinlog(writeDb, Sqlite3BinlogMode::ROW_FOR_SEARCH, TEST_SEGMENT_SIZE);
+    EXPECT_EQ(sqlite3_exec(writeDb, "create table test_rowid (id integer primary key, name text);",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(writeDb, "insert into test_rowid values (1, 'r1'), (2, 'r2'), (3, 'r3'), (4, 'r4');"
+        "insert into test_rowid values (5, 'r5'), (6, 'r6'), (7, 'r7');"
+        "insert into test_rowid values (8, 'r8'), (9, 'r9'), (10, 'r10');", nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3 *readDb = UtOpenDb(TEST_DB);
+    ASSERT_NE(readDb, nullptr);
+    UtEnableBinlog(readDb, Sqlite3BinlogMode::READ_FOR_SEARCH, TEST_SEGMENT_SIZE);
+    sqlite3 *backupDb = UtOpenDb(TEST_BACKUP_DB);
+    ASSERT_NE(backupDb, nullptr);
+    /**
+     * @tc.steps: step2. set an invalid rowid filter
+     * @tc.expected: step2. error
+     */
+    EXPECT_EQ(sqlite3_db_config(readDb, SQLITE_DBCONFIG_BINLOG_SEARCH_ROWID, (sqlite3_int64)6, (sqlite3_int64)3),
+        SQLITE_ERROR);
+    /**
+     * @tc.steps: step3. search the rows with rowid in [3, 6]
+     * @tc.expected: step3. only the 4 records in the range
+     */
+    EXPECT_EQ(sqlite3_db_config(readDb, SQLITE_DBCONFIG_BINLOG_SEARCH_ROWID, (sqlite3_int64)3, (sqlite3_int64)6),
+        SQLITE_OK);
+    BinlogSearchResultSet *rs = nullptr;
+    UtSearch(readDb, backupDb, &rs);
+    ASSERT_NE(rs, nullptr);
+    EXPECT_EQ(rs->row_count, 4);
+    for (int i = 0; i < rs->row_count; i++) {
+        EXPECT_EQ(rs->results[i].rowid, i + 3);
+    }
+    EXPECT_EQ(sqlite3_free_search_data_binlog(readDb, &rs), SQLITE_OK);
+    /**
+     * @tc.steps: step4. search all the rowids from the start again
+     * @tc.expected: step4. all 10 records
+     */
+    EXPECT_EQ(sqlite3_db_config(readDb, SQLITE_DBCONFIG_BINLOG_SEARCH_ROWID, (sqlite3_int64)1, (sqlite3_int64)10),
+        SQLITE_OK);
+    EXPECT_EQ(sqlite3_reset_search_hwm_binlog(readDb), SQLITE_OK);
+    EXPECT_EQ(UtGetSearchCount(readDb, backupDb), 10);
+    sqlite3_close_v2(readDb);
+    sqlite3_close_v2(writeDb);
+    sqlite3_close_v2(backupDb);
+}
+}  // namespace BinlogLocalTest
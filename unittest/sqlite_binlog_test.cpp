@@ -350,6 +350,318 @@ HWTEST_F(SqliteBinlogTest, BinlogReplayTest003, TestSize.Level1)
     sqlite3_close_v2(backupDb);
 }
 
+/**
+ * @tc.name: BinlogReplayTest004
+ * @tc.desc: Test replay row events of insert, update and delete onto the backup db
+ * @tc.type: FUNC
+ */
+HWTEST_F(SqliteBinlogTest, BinlogReplayTest004, TestSize.Level1)
+{
+    /**
+     * @tc.steps: step1. open db and set binlog
+     * @tc.expected: step1. ok
+     */
+    sqlite3 *db = NULL;
+    EXPECT_EQ(sqlite3_open_v2(TEST_DB, &db,
+        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr), SQLITE_OK);
+    ASSERT_NE(db, nullptr);
+    UtEnableBinlog(db);
+    /**
+     * @tc.steps: step2. Insert records, then update and delete part of them
+     * @tc.expected: step2. Execute successfully
+     */
+    static const char *UT_SQL_INSERT_DATA =
+        "INSERT INTO salary(entryId, entryName, salary, class, extra) VALUES(?,?,?,?,?);";
+    sqlite3_stmt *insertStmt = NULL;
+    EXPECT_EQ(sqlite3_prepare_v2(db, UT_SQL_INSERT_DATA, -1, &insertStmt, NULL), SQLITE_OK);
+    for (int i = 0; i < TEST_DATA_COUNT; i++) {
+        // bind parameters, 1, 2, 3, 4, 5 are sequence number of fields
+        sqlite3_bind_int(insertStmt, 1, i + 1);
+        sqlite3_bind_text(insertStmt, 2, "'salary-entry-name'", -1, SQLITE_STATIC);
+        sqlite3_bind_double(insertStmt, 3, TEST_DATA_REAL + i);
+        sqlite3_bind_int(insertStmt, 4, i + 1);
+        sqlite3_bind_blob(insertStmt, 5, &i, sizeof(i), SQLITE_TRANSIENT);
+        EXPECT_EQ(sqlite3_step(insertStmt), SQLITE_DONE);
+        sqlite3_reset(insertStmt);
+    }
+    sqlite3_finalize(insertStmt);
+    EXPECT_EQ(sqlite3_exec(db, "UPDATE salary SET entryName = 'updated', salary = salary * 2 WHERE entryId % 2 = 0;",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(db, "DELETE FROM salary WHERE entryId % 10 = 1;", nullptr, nullptr, nullptr), SQLITE_OK);
+    /**
+     * @tc.steps: step3. binlog replay to write into backup db
+     * @tc.expected: step3. Return SQLITE_OK
+     */
+    sqlite3 *backupDb = NULL;
+    EXPECT_EQ(sqlite3_open_v2(TEST_BACKUP_DB, &backupDb,
+        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr), SQLITE_OK);
+    ASSERT_NE(backupDb, nullptr);
+    EXPECT_EQ(sqlite3_replay_binlog(db, backupDb), SQLITE_OK);
+    /**
+     * @tc.steps: step4. check the content of both db
+     * @tc.expected: step4. both db have the same rows
+     */
+    static const char *UT_SQL_CHECK_DATA = "SELECT count(*), sum(salary), sum(entryName = 'updated'), "
+        "sum(length(extra)) FROM salary;";
+    sqlite3_stmt *srcStmt = NULL;
+    sqlite3_stmt *destStmt = NULL;
+    EXPECT_EQ(sqlite3_prepare_v2(db, UT_SQL_CHECK_DATA, -1, &srcStmt, NULL), SQLITE_OK);
+    EXPECT_EQ(sqlite3_prepare_v2(backupDb, UT_SQL_CHECK_DATA, -1, &destStmt, NULL), SQLITE_OK);
+    EXPECT_EQ(sqlite3_step(srcStmt), SQLITE_ROW);
+    EXPECT_EQ(sqlite3_step(destStmt), SQLITE_ROW);
+    // 9 in every 10 records are left after delete
+    EXPECT_EQ(sqlite3_column_int(destStmt, 0), TEST_DATA_COUNT / 10 * 9);
+    // 0, 1, 2, 3 are the column indexes of the check sql
+    EXPECT_EQ(sqlite3_column_int(srcStmt, 0), sqlite3_column_int(destStmt, 0));
+    EXPECT_DOUBLE_EQ(sqlite3_column_double(srcStmt, 1), sqlite3_column_double(destStmt, 1));
+    EXPECT_EQ(sqlite3_column_int(srcStmt, 2), sqlite3_column_int(destStmt, 2));
+    EXPECT_EQ(sqlite3_column_int(srcStmt, 3), sqlite3_column_int(destStmt, 3));
+    sqlite3_finalize(srcStmt);
+    sqlite3_finalize(destStmt);
+    sqlite3_close_v2(db);
+    sqlite3_close_v2(backupDb);
+}
+
+/**
+ * @tc.name: BinlogReplayTest005
+ * @tc.desc: Test replay autocommit and explicit transactions in batch
+ * @tc.type: FUNC
+ */
+HWTEST_F(SqliteBinlogTest, BinlogReplayTest005, TestSize.Level1)
+{
+    /**
+     * @tc.steps: step1. open db and set binlog
+     * @tc.expected: step1. ok
+     */
+    sqlite3 *db = NULL;
+    EXPECT_EQ(sqlite3_open_v2(TEST_DB, &db,
+        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr), SQLITE_OK);
+    ASSERT_NE(db, nullptr);
+    UtEnableBinlog(db);
+    /**
+     * @tc.steps: step2. Insert records in autocommit mode, in an explicit transaction, and after a ddl
+     * @tc.expected: step2. Execute successfully
+     */
+    static const char *UT_SQL_INSERT_DATA =
+        "INSERT INTO salary(entryId, entryName, salary, class) VALUES(?,?,?,?);";
+    sqlite3_stmt *insertStmt = NULL;
+    EXPECT_EQ(sqlite3_prepare_v2(db, UT_SQL_INSERT_DATA, -1, &insertStmt, NULL), SQLITE_OK);
+    for (int i = 0; i < TEST_DATA_COUNT; i++) {
+        // the first 3 records of every 10 are inserted in an explicit transaction
+        if (i % 10 == 0) {
+            EXPECT_EQ(sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr), SQLITE_OK);
+        }
+        // bind parameters, 1, 2, 3, 4 are sequence number of fields
+        sqlite3_bind_int(insertStmt, 1, i + 1);
+        sqlite3_bind_text(insertStmt, 2, "salary-entry-name", -1, SQLITE_STATIC);
+        sqlite3_bind_double(insertStmt, 3, TEST_DATA_REAL + i);
+        sqlite3_bind_int(insertStmt, 4, i + 1);
+        EXPECT_EQ(sqlite3_step(insertStmt), SQLITE_DONE);
+        sqlite3_reset(insertStmt);
+        if (i % 10 == 2) {
+            EXPECT_EQ(sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr), SQLITE_OK);
+        }
+    }
+    sqlite3_finalize(insertStmt);
+    EXPECT_EQ(sqlite3_exec(db, "CREATE TABLE salary2 AS SELECT * FROM salary WHERE 0;", nullptr, nullptr, nullptr),
+        SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(db, "INSERT INTO salary2 SELECT * FROM salary;", nullptr, nullptr, nullptr), SQLITE_OK);
+    /**
+     * @tc.steps: step3. set a small replay batch and binlog replay to write into backup db
+     * @tc.expected: step3. Return SQLITE_OK, and no transaction is left open in backup db
+     */
+    sqlite3 *backupDb = NULL;
+    EXPECT_EQ(sqlite3_open_v2(TEST_BACKUP_DB, &backupDb,
+        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr), SQLITE_OK);
+    ASSERT_NE(backupDb, nullptr);
+    EXPECT_EQ(sqlite3_db_config(backupDb, SQLITE_DBCONFIG_BINLOG_REPLAY_BATCH, -1, 0), SQLITE_MISUSE);
+    // commit the batch every 16 events, and no limit of bytes
+    EXPECT_EQ(sqlite3_db_config(backupDb, SQLITE_DBCONFIG_BINLOG_REPLAY_BATCH, 16, 0), SQLITE_OK);
+    EXPECT_EQ(sqlite3_replay_binlog(db, backupDb), SQLITE_OK);
+    EXPECT_NE(sqlite3_get_autocommit(backupDb), 0);
+    /**
+     * @tc.steps: step4. check db count
+     * @tc.expected: step4. both tables of backup db have TEST_DATA_COUNT
+     */
+    EXPECT_EQ(UtGetRecordCount(backupDb), TEST_DATA_COUNT);
+    int count = 0;
+    EXPECT_EQ(sqlite3_exec(backupDb, "SELECT entryId, entryName FROM salary2;", UtQueryResult, &count, nullptr),
+        SQLITE_OK);
+    EXPECT_EQ(count, TEST_DATA_COUNT);
+    sqlite3_close_v2(db);
+    sqlite3_close_v2(backupDb);
+}
+
+/**
+ * @tc.name: BinlogReplayTest006
+ * @tc.desc: Test replay rows of a table whose schema is changed in the middle of binlog
+ * @tc.type: FUNC
+ */
+HWTEST_F(SqliteBinlogTest, BinlogReplayTest006, TestSize.Level1)
+{
+    /**
+     * @tc.steps: step1. open db and set binlog
+     * @tc.expected: step1. ok
+     */
+    sqlite3 *db = NULL;
+    EXPECT_EQ(sqlite3_open_v2(TEST_DB, &db,
+        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr), SQLITE_OK);
+    ASSERT_NE(db, nullptr);
+    UtEnableBinlog(db);
+    /**
+     * @tc.steps: step2. Insert records before and after adding a column
+     * @tc.expected: step2. Execute successfully
+     */
+    EXPECT_EQ(sqlite3_exec(db, "INSERT INTO salary(entryId, entryName) VALUES(1, 'before');",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(db, "ALTER TABLE salary ADD COLUMN note TEXT;", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(db, "INSERT INTO salary(entryId, entryName, note) VALUES(2, 'after', 'note');",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(db, "UPDATE salary SET note = 'updated' WHERE entryId = 1;",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+    /**
+     * @tc.steps: step3. binlog replay to write into backup db
+     * @tc.expected: step3. Return SQLITE_OK
+     */
+    sqlite3 *backupDb = NULL;
+    EXPECT_EQ(sqlite3_open_v2(TEST_BACKUP_DB, &backupDb,
+        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr), SQLITE_OK);
+    ASSERT_NE(backupDb, nullptr);
+    EXPECT_EQ(sqlite3_replay_binlog(db, backupDb), SQLITE_OK);
+    /**
+     * @tc.steps: step4. check the new column in backup db
+     * @tc.expected: step4. both records have the note
+     */
+    int count = 0;
+    EXPECT_EQ(sqlite3_exec(backupDb, "SELECT entryId, note FROM salary WHERE note IS NOT NULL;",
+        UtQueryResult, &count, nullptr), SQLITE_OK);
+    // 2 records have note after replay
+    EXPECT_EQ(count, 2);
+    sqlite3_close_v2(db);
+    sqlite3_close_v2(backupDb);
+}
+
+/**
+ * @tc.name: BinlogReplayTest007
+ * @tc.desc: Test replay row events written before a column was added onto a backup db having the column
+ * @tc.type: FUNC
+ */
+HWTEST_F(SqliteBinlogTest, BinlogReplayTest007, TestSize.Level1)
+{
+    /**
+     * @tc.steps: step1. open db and set binlog, add a column with default value to the backup db only
+     * @tc.expected: step1. ok
+     */
+    sqlite3 *db = NULL;
+    EXPECT_EQ(sqlite3_open_v2(TEST_DB, &db,
+        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr), SQLITE_OK);
+    ASSERT_NE(db, nullptr);
+    UtEnableBinlog(db);
+    sqlite3 *backupDb = NULL;
+    EXPECT_EQ(sqlite3_open_v2(TEST_BACKUP_DB, &backupDb,
+        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr), SQLITE_OK);
+    ASSERT_NE(backupDb, nullptr);
+    EXPECT_EQ(sqlite3_exec(backupDb, "ALTER TABLE salary ADD COLUMN bonus INTEGER DEFAULT 7;",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+    /**
+     * @tc.steps: step2. Insert records, then update part of them
+     * @tc.expected: step2. Execute successfully
+     */
+    static const char *UT_SQL_INSERT_DATA =
+        "INSERT INTO salary(entryId, entryName, salary, class, extra) VALUES(?,?,?,?,?);";
+    sqlite3_stmt *insertStmt = NULL;
+    EXPECT_EQ(sqlite3_prepare_v2(db, UT_SQL_INSERT_DATA, -1, &insertStmt, NULL), SQLITE_OK);
+    for (int i = 0; i < TEST_DATA_COUNT; i++) {
+        // bind parameters, 1, 2, 3, 4, 5 are sequence number of fields
+        sqlite3_bind_int(insertStmt, 1, i + 1);
+        sqlite3_bind_text(insertStmt, 2, "salary-entry-name", -1, SQLITE_STATIC);
+        sqlite3_bind_double(insertStmt, 3, TEST_DATA_REAL + i);
+        sqlite3_bind_int(insertStmt, 4, i + 1);
+        sqlite3_bind_blob(insertStmt, 5, &i, sizeof(i), SQLITE_TRANSIENT);
+        EXPECT_EQ(sqlite3_step(insertStmt), SQLITE_DONE);
+        sqlite3_reset(insertStmt);
+    }
+    sqlite3_finalize(insertStmt);
+    EXPECT_EQ(sqlite3_exec(db, "UPDATE salary SET entryName = 'updated' WHERE entryId % 2 = 0;",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+    /**
+     * @tc.steps: step3. binlog replay to write into backup db
+     * @tc.expected: step3. Return SQLITE_OK, and the added column of every row holds its default value
+     */
+    EXPECT_EQ(sqlite3_replay_binlog(db, backupDb), SQLITE_OK);
+    sqlite3_stmt *stmt = NULL;
+    EXPECT_EQ(sqlite3_prepare_v2(backupDb, "SELECT count(*), sum(bonus = 7), sum(entryName = 'updated') FROM salary;",
+        -1, &stmt, NULL), SQLITE_OK);
+    EXPECT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    // 0, 1, 2 are the column indexes of the check sql
+    EXPECT_EQ(sqlite3_column_int(stmt, 0), TEST_DATA_COUNT);
+    EXPECT_EQ(sqlite3_column_int(stmt, 1), TEST_DATA_COUNT);
+    EXPECT_EQ(sqlite3_column_int(stmt, 2), TEST_DATA_COUNT / 2);
+    sqlite3_finalize(stmt);
+    sqlite3_close_v2(db);
+    sqlite3_close_v2(backupDb);
+}
+
+/**
+ * @tc.name: BinlogReplayTest008
+ * @tc.desc: Test replay rows of a cached table after the backup schema is reset to find a table created by
+ *           another connection
+ * @tc.type: FUNC
+ */
+HWTEST_F(SqliteBinlogTest, BinlogReplayTest008, TestSize.Level1)
+{
+    /**
+     * @tc.steps: step1. open db, create a second table, then set binlog
+     * @tc.expected: step1. ok
+     */
+    sqlite3 *db = NULL;
+    EXPECT_EQ(sqlite3_open_v2(TEST_DB, &db,
+        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr), SQLITE_OK);
+    ASSERT_NE(db, nullptr);
+    EXPECT_EQ(sqlite3_exec(db, "CREATE TABLE salary2 AS SELECT * FROM salary WHERE 0;", nullptr, nullptr, nullptr),
+        SQLITE_OK);
+    UtEnableBinlog(db);
+    /**
+     * @tc.steps: step2. load the schema of backup db, then create the second table by another connection
+     * @tc.expected: step2. Execute successfully
+     */
+    sqlite3 *backupDb = NULL;
+    EXPECT_EQ(sqlite3_open_v2(TEST_BACKUP_DB, &backupDb,
+        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr), SQLITE_OK);
+    ASSERT_NE(backupDb, nullptr);
+    EXPECT_EQ(UtGetRecordCount(backupDb), 0);
+    sqlite3 *otherDb = NULL;
+    EXPECT_EQ(sqlite3_open_v2(TEST_BACKUP_DB, &otherDb, SQLITE_OPEN_READWRITE | SQLITE_OPEN_FULLMUTEX, nullptr),
+        SQLITE_OK);
+    ASSERT_NE(otherDb, nullptr);
+    EXPECT_EQ(sqlite3_exec(otherDb, "CREATE TABLE salary2 AS SELECT * FROM salary WHERE 0;", nullptr, nullptr,
+        nullptr), SQLITE_OK);
+    sqlite3_close_v2(otherDb);
+    /**
+     * @tc.steps: step3. Insert records into both tables in turn
+     * @tc.expected: step3. Execute successfully
+     */
+    EXPECT_EQ(sqlite3_exec(db, "INSERT INTO salary(entryId, entryName) VALUES(1, 'first');",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(db, "INSERT INTO salary2(entryId, entryName) VALUES(1, 'second');",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(db, "INSERT INTO salary(entryId, entryName) VALUES(2, 'first');",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+    /**
+     * @tc.steps: step4. binlog replay to write into backup db
+     * @tc.expected: step4. Return SQLITE_OK, and both tables have their records
+     */
+    EXPECT_EQ(sqlite3_replay_binlog(db, backupDb), SQLITE_OK);
+    // 2 records in salary after replay
+    EXPECT_EQ(UtGetRecordCount(backupDb), 2);
+    int count = 0;
+    EXPECT_EQ(sqlite3_exec(backupDb, "SELECT entryId, entryName FROM salary2;", UtQueryResult, &count, nullptr),
+        SQLITE_OK);
+    EXPECT_EQ(count, 1);
+    sqlite3_close_v2(db);
+    sqlite3_close_v2(backupDb);
+}
+
 /**
  * @tc.name: BinlogInterfaceTest001
  * @tc.desc: Test replay sql with invalid db pointer
@@ -18,6 +18,7 @@
 #include <sys/types.h>
 
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <string>
 #include <unistd.h>
@@ -35,6 +36,7 @@ using namespace std;
 #define REKEY_RENAME_SUFFIX "-rekey-rename"
 #define REKEY_EXPORT_SUFFIX "-rekey-export"
 #define REKEY_LOCK_SUFFIX "-rekey-lock"
+#define REKEY_PROGRESS_SUFFIX "-rekey-progress"
 
 #define MULPROC_STEP_1 0
 #define MULPROC_STEP_2 1
@@ -177,6 +179,45 @@ static int GetRecordCount(sqlite3* db, std::string table, int &count)
     return SQLITE_OK;
 }
 
+// Helper function to run integrity check, return its first result row
+static std::string GetIntegrityCheck(sqlite3* db)
+{
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "PRAGMA integrity_check;", -1, &stmt, nullptr) != SQLITE_OK) {
+        return sqlite3_errmsg(db);
+    }
+    std::string result;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        result = (const char *)sqlite3_column_text(stmt, 0);
+    } else {
+        result = sqlite3_errmsg(db);
+    }
+    sqlite3_finalize(stmt);
+    return result;
+}
+
+// Helper function to get count of pages read ahead by the codec
+static int GetReadAheadHits(sqlite3* db)
+{
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "PRAGMA codec_read_ahead_hits;", -1, &stmt, nullptr) != SQLITE_OK) {
+        return -1;
+    }
+    int hits = -1;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        hits = sqlite3_column_int(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return hits;
+}
+
+// Helper function to read the whole content of a file
+static std::vector<unsigned char> ReadFileContent(const char *path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<unsigned char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
 static void PrepareDataForDb(sqlite3* db)
 {
     CreateTable(db, "customers", "customers_idx");
@@ -893,4 +934,629 @@ HWTEST_F(LibSQLiteRekeyTest, LibSQLiteRekeyTest015, TestSize.Level0)
     QueryData(db);
     sqlite3_close(db);
 }
-}  // namespace Test
\ No newline at end of file
+
+/**
+ * @tc.name: LibSQLiteRekeyTest016
+ * @tc.desc: Test rekey with unchanged page size rekeys pages range by range
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibSQLiteRekeyTest, LibSQLiteRekeyTest016, TestSize.Level0)
+{
+    sqlite3* db;
+    /**
+     * @tc.steps: step1. Open database and create table with more pages than one rekey range
+     * @tc.expected: step1. Return SQLITE_OK
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    CodecConfig config = {
+        "aes-256-gcm", "SHA1", "KDF_SHA1", "01234567890123456789012345678901", 32, 5000, 1024
+    };
+    EncryptDbConfig(db, &config);
+    PrepareDataForDb(db);
+    CreateTable(db, "bulk", "bulk_idx");
+    InsertRecords(db, "bulk", 5000);
+    sqlite3_close(db);
+    /**
+     * @tc.steps: step2. Rekey with new passwd
+     * @tc.expected: step2. Return SQLITE_OK and no progress file left
+     */
+    CodecRekeyConfig rekeyCfg = {
+        TEST_DB,
+        { "aes-256-gcm", "SHA1", "KDF_SHA1", "01234567890123456789012345678901", 32, 5000, 1024 },
+        { "aes-256-gcm", "SHA1", "KDF_SHA1", "11234567890123456789012345678901", 32, 5000, 1024 }
+    };
+    ASSERT_EQ(sqlite3_rekey_v3(&rekeyCfg), SQLITE_OK);
+    ASSERT_EQ(access(TEST_DB REKEY_PROGRESS_SUFFIX, F_OK), -1)
+        << "progress file should be removed";
+    /**
+     * @tc.steps: step3. Open and Decrypt with valid passwd
+     * @tc.expected: step3. Return SQLITE_OK
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    config = {
+        "aes-256-gcm", "SHA1", "KDF_SHA1", "11234567890123456789012345678901", 32, 5000, 1024
+    };
+    EncryptDbConfig(db, &config);
+    QueryData(db);
+    int count = 0;
+    EXPECT_EQ(GetRecordCount(db, "bulk", count), SQLITE_OK);
+    EXPECT_EQ(count, 5000);
+    EXPECT_EQ(GetIntegrityCheck(db), "ok");
+    sqlite3_close(db);
+}
+
+/**
+ * @tc.name: LibSQLiteRekeyTest017
+ * @tc.desc: Test export_database into a database with the same page size copies pages
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibSQLiteRekeyTest, LibSQLiteRekeyTest017, TestSize.Level0)
+{
+    sqlite3* db;
+    const char *oldKey = "01234567890123456789012345678901";
+    const char *newKey = "11234567890123456789012345678901";
+    /**
+     * @tc.steps: step1. Open database with default codec config and create table
+     * @tc.expected: step1. Return SQLITE_OK
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    ASSERT_EQ(sqlite3_key(db, oldKey, 32), SQLITE_OK);
+    PrepareDataForDb(db);
+    /**
+     * @tc.steps: step2. Export to an empty database attached with new key
+     * @tc.expected: step2. Return SQLITE_OK
+     */
+    std::string sql = std::string("ATTACH DATABASE '") + TEST_DB "-copy' AS exportDb KEY '" + newKey + "';";
+    ASSERT_EQ(sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr), SQLITE_OK) << sqlite3_errmsg(db);
+    ASSERT_EQ(sqlite3_exec(db, "SELECT export_database('exportDb');", nullptr, nullptr, nullptr), SQLITE_OK)
+        << sqlite3_errmsg(db);
+    ASSERT_EQ(sqlite3_exec(db, "DETACH DATABASE exportDb;", nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3_close(db);
+    /**
+     * @tc.steps: step3. Open the exported database with new key
+     * @tc.expected: step3. Return SQLITE_OK
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB "-copy", &db), SQLITE_OK);
+    ASSERT_EQ(sqlite3_key(db, newKey, 32), SQLITE_OK);
+    QueryData(db);
+    EXPECT_EQ(GetIntegrityCheck(db), "ok");
+    sqlite3_close(db);
+}
+
+/**
+ * @tc.name: LibSQLiteRekeyTest018
+ * @tc.desc: Test reopen encrypted database with kdf cache enabled
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibSQLiteRekeyTest, LibSQLiteRekeyTest018, TestSize.Level0)
+{
+    sqlite3* db;
+    /**
+     * @tc.steps: step1. Enable kdf cache, invalid size is refused
+     * @tc.expected: step1. Return SQLITE_OK
+     */
+    EXPECT_EQ(sqlite3_config(SQLITE_CONFIG_CODEC_KDF_CACHE, -1), SQLITE_MISUSE);
+    ASSERT_EQ(sqlite3_config(SQLITE_CONFIG_CODEC_KDF_CACHE, 8), SQLITE_OK);
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    CodecConfig config = {
+        "aes-256-gcm", "SHA1", "KDF_SHA1", "01234567890123456789012345678901", 32, 5000, 1024
+    };
+    EncryptDbConfig(db, &config);
+    PrepareDataForDb(db);
+    sqlite3_close(db);
+    /**
+     * @tc.steps: step2. Reopen with the same key several times
+     * @tc.expected: step2. Return SQLITE_OK
+     */
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+        EncryptDbConfig(db, &config);
+        QueryData(db);
+        sqlite3_close(db);
+    }
+    /**
+     * @tc.steps: step3. Reopen with invalid passwd
+     * @tc.expected: step3. Return SQLITE_NOTADB
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    config = {
+        "aes-256-gcm", "SHA1", "KDF_SHA1", "11234567890123456789012345678901", 32, 5000, 1024
+    };
+    EncryptDbConfig(db, &config);
+    int count = 0;
+    EXPECT_EQ(GetRecordCount(db, "customers", count), SQLITE_NOTADB);
+    sqlite3_close(db);
+    EXPECT_EQ(sqlite3_config(SQLITE_CONFIG_CODEC_KDF_CACHE, 0), SQLITE_OK);
+}
+
+/**
+ * @tc.name: LibSQLiteRekeyTest019
+ * @tc.desc: Test encrypted database authenticated by gcm tag
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibSQLiteRekeyTest, LibSQLiteRekeyTest019, TestSize.Level0)
+{
+    sqlite3* db;
+    /**
+     * @tc.steps: step1. Create encrypted database with gcm tag
+     * @tc.expected: step1. Return SQLITE_OK
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    CodecConfig config = {
+        "aes-256-gcm", "SHA256", "KDF_SHA256", "01234567890123456789012345678901", 32, 5000, 4096
+    };
+    EncryptDbConfig(db, &config);
+    ASSERT_EQ(sqlite3_exec(db, "PRAGMA codec_gcm_tag=ON;", nullptr, nullptr, nullptr), SQLITE_OK);
+    PrepareDataForDb(db);
+    sqlite3_close(db);
+    /**
+     * @tc.steps: step2. Reopen with gcm tag
+     * @tc.expected: step2. Return SQLITE_OK
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    EncryptDbConfig(db, &config);
+    ASSERT_EQ(sqlite3_exec(db, "PRAGMA codec_gcm_tag=ON;", nullptr, nullptr, nullptr), SQLITE_OK);
+    QueryData(db);
+    EXPECT_EQ(GetIntegrityCheck(db), "ok");
+    sqlite3_close(db);
+    /**
+     * @tc.steps: step3. Reopen with hmac
+     * @tc.expected: step3. Return SQLITE_NOTADB
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    EncryptDbConfig(db, &config);
+    int count = 0;
+    EXPECT_EQ(GetRecordCount(db, "customers", count), SQLITE_NOTADB);
+    sqlite3_close(db);
+    /**
+     * @tc.steps: step4. Rekey with new passwd and gcm tag kept
+     * @tc.expected: step4. Return SQLITE_OK
+     */
+    CodecRekeyConfigV2 rekeyCfg = {
+        TEST_DB,
+        { { "aes-256-gcm", "SHA256", "KDF_SHA256", "01234567890123456789012345678901", 32, 5000, 4096 }, 1 },
+        { { "aes-256-gcm", "SHA256", "KDF_SHA256", "11234567890123456789012345678901", 32, 5000, 4096 }, 1 }
+    };
+    ASSERT_EQ(sqlite3_rekey_v4(&rekeyCfg), SQLITE_OK);
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    config = {
+        "aes-256-gcm", "SHA256", "KDF_SHA256", "11234567890123456789012345678901", 32, 5000, 4096
+    };
+    EncryptDbConfig(db, &config);
+    ASSERT_EQ(sqlite3_exec(db, "PRAGMA codec_gcm_tag=ON;", nullptr, nullptr, nullptr), SQLITE_OK);
+    QueryData(db);
+    EXPECT_EQ(GetIntegrityCheck(db), "ok");
+    sqlite3_close(db);
+    /**
+     * @tc.steps: step5. Rekey without gcm tag changes the reserve size
+     * @tc.expected: step5. Return SQLITE_OK, the database is read with hmac and not with gcm tag
+     */
+    rekeyCfg = {
+        TEST_DB,
+        { { "aes-256-gcm", "SHA256", "KDF_SHA256", "11234567890123456789012345678901", 32, 5000, 4096 }, 1 },
+        { { "aes-256-gcm", "SHA256", "KDF_SHA256", "21234567890123456789012345678901", 32, 5000, 4096 }, 0 }
+    };
+    ASSERT_EQ(sqlite3_rekey_v4(&rekeyCfg), SQLITE_OK);
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    config = {
+        "aes-256-gcm", "SHA256", "KDF_SHA256", "21234567890123456789012345678901", 32, 5000, 4096
+    };
+    EncryptDbConfig(db, &config);
+    QueryData(db);
+    EXPECT_EQ(GetIntegrityCheck(db), "ok");
+    sqlite3_close(db);
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    EncryptDbConfig(db, &config);
+    ASSERT_EQ(sqlite3_exec(db, "PRAGMA codec_gcm_tag=ON;", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(GetRecordCount(db, "customers", count), SQLITE_NOTADB);
+    sqlite3_close(db);
+    /**
+     * @tc.steps: step6. Gcm tag is refused for cbc cipher
+     * @tc.expected: step6. Return SQLITE_ERROR
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB "-cbc", &db), SQLITE_OK);
+    config = {
+        "aes-256-cbc", "SHA256", "KDF_SHA256", "01234567890123456789012345678901", 32, 5000, 4096
+    };
+    EncryptDbConfig(db, &config);
+    EXPECT_EQ(sqlite3_exec(db, "PRAGMA codec_gcm_tag=ON;", nullptr, nullptr, nullptr), SQLITE_ERROR);
+    sqlite3_close(db);
+}
+
+/**
+ * @tc.name: LibSQLiteRekeyTest020
+ * @tc.desc: Test sequential scan of encrypted database reads pages ahead
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibSQLiteRekeyTest, LibSQLiteRekeyTest020, TestSize.Level0)
+{
+    sqlite3* db;
+    /**
+     * @tc.steps: step1. Create encrypted database with pages in the database file
+     * @tc.expected: step1. Return SQLITE_OK
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    CodecConfig config = {
+        "aes-256-gcm", "SHA1", "KDF_SHA1", "01234567890123456789012345678901", 32, 5000, 1024
+    };
+    EncryptDbConfig(db, &config);
+    CreateTable(db, "bulk", "bulk_idx");
+    InsertRecords(db, "bulk", 5000);
+    ASSERT_EQ(sqlite3_exec(db, "PRAGMA wal_checkpoint(TRUNCATE);", nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3_close(db);
+    /**
+     * @tc.steps: step2. Scan the table, then change it and scan again
+     * @tc.expected: step2. Return SQLITE_OK and the latest count
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    EncryptDbConfig(db, &config);
+    int count = 0;
+    EXPECT_EQ(GetRecordCount(db, "bulk", count), SQLITE_OK);
+    EXPECT_EQ(count, 5000);
+    // The count is only reported by builds with SQLITE_TEST
+    int hits = GetReadAheadHits(db);
+    if (hits >= 0) {
+        EXPECT_GT(hits, 0) << "pages of the scan should be read ahead";
+    }
+    ASSERT_EQ(sqlite3_exec(db, "INSERT INTO bulk(name, users) SELECT name, users || '_new' FROM bulk WHERE id < 100;",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(GetRecordCount(db, "bulk", count), SQLITE_OK);
+    EXPECT_EQ(count, 5100);
+    ASSERT_EQ(sqlite3_exec(db, "PRAGMA wal_checkpoint(TRUNCATE);", nullptr, nullptr, nullptr), SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(db, "DELETE FROM bulk WHERE rowid % 2 = 0;", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(GetRecordCount(db, "bulk", count), SQLITE_OK);
+    EXPECT_EQ(count, 2550);
+    EXPECT_EQ(GetIntegrityCheck(db), "ok");
+    sqlite3_close(db);
+}
+
+/**
+ * @tc.name: LibSQLiteRekeyTest021
+ * @tc.desc: Test rekey of encrypted database in envelope mode
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibSQLiteRekeyTest, LibSQLiteRekeyTest021, TestSize.Level0)
+{
+    sqlite3* db;
+    /**
+     * @tc.steps: step1. Create encrypted database in envelope mode
+     * @tc.expected: step1. Return SQLITE_OK
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    CodecConfig config = {
+        "aes-256-gcm", "SHA256", "KDF_SHA256", "01234567890123456789012345678901", 32, 5000, 4096
+    };
+    EncryptDbConfig(db, &config);
+    ASSERT_EQ(sqlite3_exec(db, "PRAGMA codec_envelope=ON;", nullptr, nullptr, nullptr), SQLITE_OK);
+    CreateTable(db, "bulk", "bulk_idx");
+    InsertRecords(db, "bulk", 1000);
+    ASSERT_EQ(sqlite3_exec(db, "PRAGMA wal_checkpoint(TRUNCATE);", nullptr, nullptr, nullptr), SQLITE_OK);
+    std::vector<unsigned char> oldContent = ReadFileContent(TEST_DB);
+    ASSERT_GT(oldContent.size(), 4096u);
+    /**
+     * @tc.steps: step2. Rekey the database, only the wrapped data key is changed
+     * @tc.expected: step2. Return SQLITE_OK and only page 1 is written into wal
+     */
+    const char *newKey = "abcdefghijabcdefghijabcdefghij01";
+    ASSERT_EQ(sqlite3_exec(db, "PRAGMA codec_rekey_hmac_algo='SHA256';", nullptr, nullptr, nullptr), SQLITE_OK);
+    ASSERT_EQ(sqlite3_rekey(db, newKey, 32), SQLITE_OK);
+    int count = 0;
+    EXPECT_EQ(GetRecordCount(db, "bulk", count), SQLITE_OK);
+    EXPECT_EQ(count, 1000);
+    /**
+     * @tc.steps: step3. Open another connection with the new key while page 1 is only in wal
+     * @tc.expected: step3. Return SQLITE_OK
+     */
+    sqlite3* newDb;
+    ASSERT_EQ(sqlite3_open(TEST_DB, &newDb), SQLITE_OK);
+    CodecConfig newConfig = {
+        "aes-256-gcm", "SHA256", "KDF_SHA256", newKey, 32, 5000, 4096
+    };
+    EncryptDbConfig(newDb, &newConfig);
+    ASSERT_EQ(sqlite3_exec(newDb, "PRAGMA codec_envelope=ON;", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(GetRecordCount(newDb, "bulk", count), SQLITE_OK);
+    EXPECT_EQ(count, 1000);
+    sqlite3_close(newDb);
+    int nLog = 0;
+    int nCkpt = 0;
+    ASSERT_EQ(sqlite3_wal_checkpoint_v2(db, "main", SQLITE_CHECKPOINT_TRUNCATE, &nLog, &nCkpt), SQLITE_OK);
+    EXPECT_EQ(nLog, 1) << "only page 1 should be rewritten";
+    sqlite3_close(db);
+    std::vector<unsigned char> newContent = ReadFileContent(TEST_DB);
+    ASSERT_EQ(newContent.size(), oldContent.size());
+    EXPECT_NE(memcmp(newContent.data(), oldContent.data(), 4096), 0);
+    EXPECT_EQ(memcmp(newContent.data() + 4096, oldContent.data() + 4096, oldContent.size() - 4096), 0);
+    /**
+     * @tc.steps: step4. Reopen with the new key
+     * @tc.expected: step4. Return SQLITE_OK
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    EncryptDbConfig(db, &newConfig);
+    ASSERT_EQ(sqlite3_exec(db, "PRAGMA codec_envelope=ON;", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(GetRecordCount(db, "bulk", count), SQLITE_OK);
+    EXPECT_EQ(count, 1000);
+    EXPECT_EQ(GetIntegrityCheck(db), "ok");
+    sqlite3_close(db);
+    /**
+     * @tc.steps: step5. Reopen with the old key
+     * @tc.expected: step5. Return SQLITE_NOTADB
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    EncryptDbConfig(db, &config);
+    ASSERT_EQ(sqlite3_exec(db, "PRAGMA codec_envelope=ON;", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(GetRecordCount(db, "bulk", count), SQLITE_NOTADB);
+    sqlite3_close(db);
+}
+
+/**
+ * @tc.name: LibSQLiteRekeyTest022
+ * @tc.desc: Test db rekey page changed waits others process to close
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibSQLiteRekeyTest, LibSQLiteRekeyTest022, TestSize.Level0)
+{
+    size_t mapSize = sizeof(int);
+    int *shared = (int *)mmap(nullptr, mapSize, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(shared, MAP_FAILED);
+    *shared = MULPROC_STEP_1;
+    CodecConfig config = {
+        "aes-256-gcm", "SHA256", "KDF_SHA256", "01234567890123456789012345678901", 32, 5000, 4096
+    };
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    // child
+    if (pid == 0) {
+        sqlite3* db;
+        /**
+        * @tc.steps: step1. Open database and create table
+        * @tc.expected: step1. Return SQLITE_OK
+        */
+        ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+        EncryptDbConfig(db, &config);
+        PrepareDataForDb(db);
+        *shared = MULPROC_STEP_2;
+        while (*shared != MULPROC_STEP_3) {
+            usleep(20);
+        }
+        // commit while rekey is running, then close
+        ASSERT_EQ(sqlite3_exec(db, "INSERT INTO customers VALUES (1000, 'User_1000', 'user1000@example.com');",
+            nullptr, nullptr, nullptr), SQLITE_OK);
+        usleep(100000);
+        sqlite3_close(db);
+        exit(0);
+    }
+    /**
+    * @tc.steps: step2. Rekey and pagesize changed while others process is open
+    * @tc.expected: step2. Return SQLITE_OK after others process closed
+    */
+    CodecRekeyConfig rekeyCfg = {
+        TEST_DB,
+        { "aes-256-gcm", "SHA256", "KDF_SHA256", "01234567890123456789012345678901", 32, 5000, 4096 },
+        { "aes-256-gcm", "SHA1", "KDF_SHA1", "01234567890123456789012345678901", 32, 5000, 1024 },
+    };
+    while (*shared != MULPROC_STEP_2) {
+        usleep(20);
+    }
+    *shared = MULPROC_STEP_3;
+    EXPECT_EQ(sqlite3_rekey_v3(&rekeyCfg), SQLITE_OK);
+    waitpid(pid, 0, 0);
+    ASSERT_NE(munmap(shared, mapSize), -1);
+    /**
+    * @tc.steps: step3. Open database with new config
+    * @tc.expected: step3. Return SQLITE_OK and the row committed during rekey
+    */
+    sqlite3* db;
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    config = { "aes-256-gcm", "SHA1", "KDF_SHA1", "01234567890123456789012345678901", 32, 5000, 1024 };
+    EncryptDbConfig(db, &config);
+    int count = 0;
+    EXPECT_EQ(GetRecordCount(db, "customers", count), SQLITE_OK);
+    EXPECT_EQ(count, 51);
+    sqlite3_close(db);
+}
+
+/**
+ * @tc.name: LibSQLiteRekeyTest024
+ * @tc.desc: Test interrupted rekey with unchanged page size is resumed while a reader goes on
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibSQLiteRekeyTest, LibSQLiteRekeyTest024, TestSize.Level0)
+{
+    sqlite3* db;
+    sqlite3* reader;
+    /**
+     * @tc.steps: step1. Create encrypted database with more pages than two rekey ranges
+     * @tc.expected: step1. Return SQLITE_OK
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    CodecConfig config = {
+        "aes-256-gcm", "SHA1", "KDF_SHA1", "01234567890123456789012345678901", 32, 5000, 1024
+    };
+    EncryptDbConfig(db, &config);
+    CreateTable(db, "bulk", "bulk_idx");
+    InsertRecords(db, "bulk", 5000);
+    sqlite3_close(db);
+    /**
+     * @tc.steps: step2. Open a reader with old passwd and forge one byte of page 200
+     * @tc.expected: step2. Return SQLITE_OK
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &reader), SQLITE_OK);
+    EncryptDbConfig(reader, &config);
+    int fd = open(TEST_DB, O_RDWR);
+    ASSERT_GT(fd, 0);
+    unsigned char byte = 0;
+    ASSERT_EQ(pread(fd, &byte, 1, 1024 * 199 + 100), 1);
+    unsigned char forged = byte ^ 0xff;
+    ASSERT_EQ(pwrite(fd, &forged, 1, 1024 * 199 + 100), 1);
+    /**
+     * @tc.steps: step3. Rekey is interrupted by the forged page, then restore the page
+     * @tc.expected: step3. Return error and the progress file is kept
+     */
+    CodecRekeyConfig rekeyCfg = {
+        TEST_DB,
+        { "aes-256-gcm", "SHA1", "KDF_SHA1", "01234567890123456789012345678901", 32, 5000, 1024 },
+        { "aes-256-gcm", "SHA1", "KDF_SHA1", "11234567890123456789012345678901", 32, 5000, 1024 }
+    };
+    EXPECT_NE(sqlite3_rekey_v3(&rekeyCfg), SQLITE_OK);
+    EXPECT_EQ(access(TEST_DB REKEY_PROGRESS_SUFFIX, F_OK), 0) << "progress file should be kept";
+    ASSERT_EQ(pwrite(fd, &byte, 1, 1024 * 199 + 100), 1);
+    close(fd);
+    /**
+     * @tc.steps: step4. The reader reads pages with both keys, but its write is refused
+     * @tc.expected: step4. Return SQLITE_OK for read and error for write
+     */
+    int count = 0;
+    EXPECT_EQ(GetRecordCount(reader, "bulk", count), SQLITE_OK);
+    EXPECT_EQ(count, 5000);
+    EXPECT_NE(sqlite3_exec(reader, "INSERT INTO bulk VALUES (5000, 'User_5000', 'user5000@example.com');",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+    /**
+     * @tc.steps: step5. Resume with another new passwd
+     * @tc.expected: step5. Return SQLITE_MISUSE
+     */
+    CodecRekeyConfig wrongCfg = {
+        TEST_DB,
+        { "aes-256-gcm", "SHA1", "KDF_SHA1", "01234567890123456789012345678901", 32, 5000, 1024 },
+        { "aes-256-gcm", "SHA1", "KDF_SHA1", "21234567890123456789012345678901", 32, 5000, 1024 }
+    };
+    EXPECT_EQ(sqlite3_rekey_v3(&wrongCfg), SQLITE_MISUSE);
+    /**
+     * @tc.steps: step6. Resume while the reader is open
+     * @tc.expected: step6. Return SQLITE_OK and no progress file left
+     */
+    EXPECT_EQ(sqlite3_rekey_v3(&rekeyCfg), SQLITE_OK);
+    EXPECT_EQ(access(TEST_DB REKEY_PROGRESS_SUFFIX, F_OK), -1) << "progress file should be removed";
+    /**
+     * @tc.steps: step7. The reader switches to new passwd, it reads all records and writes
+     * @tc.expected: step7. Return SQLITE_OK
+     */
+    EXPECT_EQ(GetRecordCount(reader, "bulk", count), SQLITE_OK);
+    EXPECT_EQ(count, 5000);
+    EXPECT_EQ(sqlite3_exec(reader, "INSERT INTO bulk VALUES (5000, 'User_5000', 'user5000@example.com');",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3_close(reader);
+    /**
+     * @tc.steps: step8. Open and Decrypt with new passwd
+     * @tc.expected: step8. Return SQLITE_OK
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    config = {
+        "aes-256-gcm", "SHA1", "KDF_SHA1", "11234567890123456789012345678901", 32, 5000, 1024
+    };
+    EncryptDbConfig(db, &config);
+    EXPECT_EQ(GetRecordCount(db, "bulk", count), SQLITE_OK);
+    EXPECT_EQ(count, 5001);
+    EXPECT_EQ(GetIntegrityCheck(db), "ok");
+    sqlite3_close(db);
+}
+
+/**
+ * @tc.name: LibSQLiteRekeyTest025
+ * @tc.desc: Test big transactions of encrypted database encrypt the dirty pages in batch
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibSQLiteRekeyTest, LibSQLiteRekeyTest025, TestSize.Level0)
+{
+    sqlite3* db;
+    /**
+     * @tc.steps: step1. Write hundreds of pages by one transaction in rollback journal mode, then in wal mode
+     * @tc.expected: step1. Return SQLITE_OK
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    CodecConfig config = {
+        "aes-256-gcm", "SHA1", "KDF_SHA1", "01234567890123456789012345678901", 32, 5000, 1024
+    };
+    EncryptDbConfig(db, &config);
+    ASSERT_EQ(sqlite3_exec(db, "PRAGMA journal_mode=DELETE;", nullptr, nullptr, nullptr), SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(db, "CREATE TABLE bulk(id INTEGER PRIMARY KEY, data BLOB);", nullptr, nullptr, nullptr),
+        SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(db, "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 2000) "
+        "INSERT INTO bulk SELECT x, randomblob(300) FROM c;", nullptr, nullptr, nullptr), SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr), SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(db, "UPDATE bulk SET data = randomblob(300) WHERE id % 2 = 0;", nullptr, nullptr, nullptr),
+        SQLITE_OK);
+    /**
+     * @tc.steps: step2. Write a transaction bigger than the page cache, the dirty pages are spilled
+     * @tc.expected: step2. Return SQLITE_OK
+     */
+    ASSERT_EQ(sqlite3_exec(db, "PRAGMA cache_size=20;", nullptr, nullptr, nullptr), SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(db, "BEGIN;UPDATE bulk SET data = randomblob(300) WHERE id % 3 = 0;"
+        "DELETE FROM bulk WHERE id > 1500;COMMIT;", nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3_close(db);
+    /**
+     * @tc.steps: step3. Reopen and check the database before and after checkpoint
+     * @tc.expected: step3. Return SQLITE_OK and the latest count
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    EncryptDbConfig(db, &config);
+    int count = 0;
+    EXPECT_EQ(GetRecordCount(db, "bulk", count), SQLITE_OK);
+    EXPECT_EQ(count, 1500);
+    EXPECT_EQ(GetIntegrityCheck(db), "ok");
+    ASSERT_EQ(sqlite3_exec(db, "PRAGMA wal_checkpoint(TRUNCATE);", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(GetIntegrityCheck(db), "ok");
+    sqlite3_close(db);
+}
+}  // namespace Test
+
+/**
+ * @tc.name: LibSQLiteRekeyTest026
+ * @tc.desc: Test a connection opened after the rekey is interrupted refuses the rekeyed pages until it is resumed
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibSQLiteRekeyTest, LibSQLiteRekeyTest026, TestSize.Level0)
+{
+    sqlite3* db;
+    /**
+     * @tc.steps: step1. Create encrypted database with more pages than two rekey ranges
+     * @tc.expected: step1. Return SQLITE_OK
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    CodecConfig config = {
+        "aes-256-gcm", "SHA1", "KDF_SHA1", "01234567890123456789012345678901", 32, 5000, 1024
+    };
+    EncryptDbConfig(db, &config);
+    CreateTable(db, "bulk", "bulk_idx");
+    InsertRecords(db, "bulk", 5000);
+    sqlite3_close(db);
+    /**
+     * @tc.steps: step2. Rekey is interrupted by a forged page 200 while no other connection is open
+     * @tc.expected: step2. Return error and the progress file is kept
+     */
+    int fd = open(TEST_DB, O_RDWR);
+    ASSERT_GT(fd, 0);
+    unsigned char byte = 0;
+    ASSERT_EQ(pread(fd, &byte, 1, 1024 * 199 + 100), 1);
+    unsigned char forged = byte ^ 0xff;
+    ASSERT_EQ(pwrite(fd, &forged, 1, 1024 * 199 + 100), 1);
+    CodecRekeyConfig rekeyCfg = {
+        TEST_DB,
+        { "aes-256-gcm", "SHA1", "KDF_SHA1", "01234567890123456789012345678901", 32, 5000, 1024 },
+        { "aes-256-gcm", "SHA1", "KDF_SHA1", "11234567890123456789012345678901", 32, 5000, 1024 }
+    };
+    EXPECT_NE(sqlite3_rekey_v3(&rekeyCfg), SQLITE_OK);
+    EXPECT_EQ(access(TEST_DB REKEY_PROGRESS_SUFFIX, F_OK), 0) << "progress file should be kept";
+    ASSERT_EQ(pwrite(fd, &byte, 1, 1024 * 199 + 100), 1);
+    close(fd);
+    /**
+     * @tc.steps: step3. Open a connection with old passwd, it only knows the old key
+     * @tc.expected: step3. Return SQLITE_BUSY for the rekeyed pages instead of SQLITE_CORRUPT, and refuse to write
+     */
+    ASSERT_EQ(sqlite3_open(TEST_DB, &db), SQLITE_OK);
+    EncryptDbConfig(db, &config);
+    EXPECT_EQ(sqlite3_exec(db, "SELECT COUNT(*) FROM bulk;", nullptr, nullptr, nullptr), SQLITE_BUSY);
+    EXPECT_NE(sqlite3_exec(db, "INSERT INTO bulk VALUES (5000, 'User_5000', 'user5000@example.com');",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+    /**
+     * @tc.steps: step4. Resume while the connection is open
+     * @tc.expected: step4. Return SQLITE_OK, the connection switches to new passwd and reads all records
+     */
+    EXPECT_EQ(sqlite3_rekey_v3(&rekeyCfg), SQLITE_OK);
+    EXPECT_EQ(access(TEST_DB REKEY_PROGRESS_SUFFIX, F_OK), -1) << "progress file should be removed";
+    int count = 0;
+    EXPECT_EQ(GetRecordCount(db, "bulk", count), SQLITE_OK);
+    EXPECT_EQ(count, 5000);
+    EXPECT_EQ(GetIntegrityCheck(db), "ok");
+    sqlite3_close(db);
+}
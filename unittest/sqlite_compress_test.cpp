@@ -784,4 +784,317 @@ HWTEST_F(SQLiteCompressTest, CompressTest015, TestSize.Level0)
     sqlite3_close_v2(slaveDb);
 }
 
+
+/**
+ * @tc.name: CompressTest016
+ * @tc.desc: Test to convert a plain db to compressed db and back in steps
+ * @tc.type: FUNC
+ */
+HWTEST_F(SQLiteCompressTest, CompressTest016, TestSize.Level0)
+{
+    if (!IsSupportPageCompress()) {
+        GTEST_SKIP() << "Current testcase is not compatible";
+    }
+    /**
+     * @tc.steps: step1. Convert the plain db to compressed db, 2 pages per step
+     * @tc.expected: step1. Execute successfully, the plain db keeps writable between steps
+     */
+    std::string compressPath = TEST_DIR "/test016_compress.db";
+    sqlite3_compressdb_convert *convert = sqlite3_compressdb_convert_init(db_, compressPath.c_str(),
+        COMPRESSDB_CONVERT_COMPRESS);
+    ASSERT_TRUE(convert != nullptr);
+    EXPECT_EQ(sqlite3_compressdb_convert_step(convert, 2), SQLITE_OK);  // 2 means the page count of one step
+    EXPECT_GT(sqlite3_compressdb_convert_remaining(convert), 0);
+    EXPECT_EQ(sqlite3_exec(db_, UT_DDL_CREATE_DEMO.c_str(), nullptr, nullptr, nullptr), SQLITE_OK);
+    int rc = SQLITE_OK;
+    while ((rc = sqlite3_compressdb_convert_step(convert, 2)) == SQLITE_OK) {  // 2 means the page count of one step
+    }
+    EXPECT_EQ(rc, SQLITE_DONE);
+    EXPECT_EQ(sqlite3_compressdb_convert_remaining(convert), 0);
+    EXPECT_EQ(sqlite3_compressdb_convert_finish(convert), SQLITE_OK);
+    UtCheckDb(compressPath, TEST_COMPRESS_META_TABLE + 1);  // 1 means the vfs_convert table
+    sqlite3 *compressDb = nullptr;
+    EXPECT_EQ(sqlite3_open_v2(compressPath.c_str(), &compressDb, SQLITE_OPEN_READWRITE, "compressvfs"), SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(compressDb, "SELECT COUNT(*) FROM demo;", nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3_close_v2(compressDb);
+    /**
+     * @tc.steps: step2. Convert the compressed db back to plain db
+     * @tc.expected: step2. Execute successfully, the plain db has the same tables
+     */
+    std::string plainPath = TEST_DIR "/test016_plain.db";
+    EXPECT_EQ(sqlite3_open_v2(compressPath.c_str(), &compressDb, SQLITE_OPEN_READWRITE, nullptr), SQLITE_OK);
+    convert = sqlite3_compressdb_convert_init(compressDb, plainPath.c_str(), COMPRESSDB_CONVERT_DECOMPRESS);
+    ASSERT_TRUE(convert != nullptr);
+    EXPECT_EQ(sqlite3_compressdb_convert_step(convert, -1), SQLITE_DONE);
+    EXPECT_EQ(sqlite3_compressdb_convert_finish(convert), SQLITE_OK);
+    sqlite3_close_v2(compressDb);
+    UtCheckDb(plainPath, TEST_PRESET_TABLE_COUNT + 2);  // 2 means the phone and demo table
+}
+
+/**
+ * @tc.name: CompressTest017
+ * @tc.desc: Test to query the compression statistics of each btree by compress_stat
+ * @tc.type: FUNC
+ */
+HWTEST_F(SQLiteCompressTest, CompressTest017, TestSize.Level0)
+{
+    if (!IsSupportPageCompress()) {
+        GTEST_SKIP() << "Current testcase is not compatible";
+    }
+    /**
+     * @tc.steps: step1. Create a compressed db with the salary table, query compress_stat
+     * @tc.expected: step1. Execute successfully, the salary table is compressed
+     */
+    std::string dbPath = TEST_DIR "/test017_compress.db";
+    UtPresetDb(dbPath, "compressvfs");
+    sqlite3 *db = nullptr;
+    EXPECT_EQ(sqlite3_open_v2(dbPath.c_str(), &db, SQLITE_OPEN_READWRITE, "compressvfs"), SQLITE_OK);
+    sqlite3_stmt *stmt = nullptr;
+    EXPECT_EQ(sqlite3_prepare_v2(db, "SELECT pages, compressed, uncompressed, ratio FROM compress_stat "
+        "WHERE name='salary';", -1, &stmt, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    EXPECT_GT(sqlite3_column_int64(stmt, 0), 0);
+    EXPECT_LT(sqlite3_column_int64(stmt, 1), sqlite3_column_int64(stmt, 2));
+    EXPECT_GT(sqlite3_column_double(stmt, 3), 1.0);  // 1.0 means no compression
+    sqlite3_finalize(stmt);
+    sqlite3_close_v2(db);
+    /**
+     * @tc.steps: step2. Query compress_stat on a plain db
+     * @tc.expected: step2. No such table
+     */
+    EXPECT_EQ(sqlite3_exec(db_, "SELECT * FROM compress_stat;", nullptr, nullptr, nullptr), SQLITE_ERROR);
+}
+
+/**
+ * @tc.name: CompressTest018
+ * @tc.desc: Test to commit into the WAL of compressed db and compress the pages by checkpoint
+ * @tc.type: FUNC
+ */
+HWTEST_F(SQLiteCompressTest, CompressTest018, TestSize.Level0)
+{
+    if (!IsSupportPageCompress()) {
+        GTEST_SKIP() << "Current testcase is not compatible";
+    }
+    /**
+     * @tc.steps: step1. Commit several transactions into the WAL of compressed db
+     * @tc.expected: step1. Execute successfully, the pages stay in the WAL before checkpoint
+     */
+    std::string dbPath = TEST_DIR "/test018_compress.db";
+    sqlite3 *db = nullptr;
+    EXPECT_EQ(sqlite3_open_v2(dbPath.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, "compressvfs"),
+        SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(db, "PRAGMA wal_autocheckpoint=0;", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(db, UT_DDL_CREATE_DEMO.c_str(), nullptr, nullptr, nullptr), SQLITE_OK);
+    for (int i = 0; i < TEST_PRESET_DATA_COUNT; i++) {
+        EXPECT_EQ(sqlite3_exec(db, "INSERT INTO demo(name) VALUES(randomblob(1000));", nullptr, nullptr, nullptr),
+            SQLITE_OK);
+    }
+    sqlite3 *outterDb = nullptr;
+    EXPECT_EQ(sqlite3_open_v2(dbPath.c_str(), &outterDb, SQLITE_OPEN_READWRITE, nullptr), SQLITE_OK);
+    sqlite3_stmt *stmt = nullptr;
+    EXPECT_EQ(sqlite3_prepare_v2(outterDb, "SELECT COUNT(*) FROM vfs_pages;", -1, &stmt, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    int pageCount = sqlite3_column_int(stmt, 0);
+    sqlite3_reset(stmt);
+    /**
+     * @tc.steps: step2. Checkpoint the WAL of compressed db
+     * @tc.expected: step2. Execute successfully, all of the pages are compressed into vfs_pages
+     */
+    EXPECT_EQ(sqlite3_exec(db, "PRAGMA wal_checkpoint(TRUNCATE);", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    EXPECT_GT(sqlite3_column_int(stmt, 0), pageCount);
+    sqlite3_finalize(stmt);
+    sqlite3_close_v2(outterDb);
+    sqlite3_close_v2(db);
+    EXPECT_EQ(sqlite3_open_v2(dbPath.c_str(), &db, SQLITE_OPEN_READWRITE, "compressvfs"), SQLITE_OK);
+    EXPECT_EQ(sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM demo;", -1, &stmt, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    EXPECT_EQ(sqlite3_column_int(stmt, 0), TEST_PRESET_DATA_COUNT);
+    sqlite3_finalize(stmt);
+    sqlite3_close_v2(db);
+}
+
+/**
+ * @tc.name: CompressTest019
+ * @tc.desc: Test to configure the compression level and recompress the cold pages by pragma
+ * @tc.type: FUNC
+ */
+HWTEST_F(SQLiteCompressTest, CompressTest019, TestSize.Level0)
+{
+    if (!IsSupportPageCompress()) {
+        GTEST_SKIP() << "Current testcase is not compatible";
+    }
+    /**
+     * @tc.steps: step1. Set compress_level of a compressed db, then reopen it
+     * @tc.expected: step1. Execute successfully, the level is persisted, the codec can not be changed
+     */
+    std::string dbPath = TEST_DIR "/test019_compress.db";
+    UtPresetDb(dbPath, "compressvfs");
+    sqlite3 *db = nullptr;
+    EXPECT_EQ(sqlite3_open_v2(dbPath.c_str(), &db, SQLITE_OPEN_READWRITE, "compressvfs"), SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(db, "PRAGMA compress_level=9;", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(db, "PRAGMA compress_level=100;", nullptr, nullptr, nullptr), SQLITE_ERROR);
+    EXPECT_EQ(sqlite3_exec(db, "PRAGMA compress_codec=unknown;", nullptr, nullptr, nullptr), SQLITE_ERROR);
+    sqlite3_close_v2(db);
+    EXPECT_EQ(sqlite3_open_v2(dbPath.c_str(), &db, SQLITE_OPEN_READWRITE, "compressvfs"), SQLITE_OK);
+    sqlite3_stmt *stmt = nullptr;
+    EXPECT_EQ(sqlite3_prepare_v2(db, "PRAGMA compress_level;", -1, &stmt, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    EXPECT_EQ(sqlite3_column_int(stmt, 0), 9);  // 9 means the level set before
+    sqlite3_finalize(stmt);
+    /**
+     * @tc.steps: step2. Recompress the cold pages in batches
+     * @tc.expected: step2. Execute successfully, all of the pages are recompressed and still readable
+     */
+    int total = 0;
+    int count = 0;
+    do {
+        EXPECT_EQ(sqlite3_prepare_v2(db, "PRAGMA compress_recompress=2;", -1, &stmt, nullptr), SQLITE_OK);
+        EXPECT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+        count = sqlite3_column_int(stmt, 0);
+        total += count;
+        sqlite3_finalize(stmt);
+    } while (count > 0);
+    EXPECT_GT(total, 0);
+    EXPECT_EQ(sqlite3_exec(db, "PRAGMA compress_recompress=100000000;", nullptr, nullptr, nullptr), SQLITE_ERROR);
+    sqlite3_close_v2(db);
+    /**
+     * @tc.steps: step3. Check vfs_pages and the recompress cursor in the OutterDB
+     * @tc.expected: step3. No page is left to recompress, the cursor wrapped to the head of vfs_pages
+     */
+    sqlite3 *outterDb = nullptr;
+    EXPECT_EQ(sqlite3_open_v2(dbPath.c_str(), &outterDb, SQLITE_OPEN_READONLY, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_prepare_v2(outterDb, "SELECT count(*) FROM vfs_pages WHERE level IS NULL;", -1, &stmt, nullptr),
+        SQLITE_OK);
+    EXPECT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    EXPECT_EQ(sqlite3_column_int(stmt, 0), 0);
+    sqlite3_finalize(stmt);
+    EXPECT_EQ(sqlite3_prepare_v2(outterDb, "SELECT recompress FROM vfs_compression;", -1, &stmt, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    EXPECT_EQ(sqlite3_column_int(stmt, 0), 0);
+    sqlite3_finalize(stmt);
+    sqlite3_close_v2(outterDb);
+    UtCheckPresetDb(dbPath, "compressvfs");
+}
+
+static std::string UtGetCompressCodec(sqlite3 *db)
+{
+    sqlite3_stmt *stmt = nullptr;
+    std::string codec;
+    EXPECT_EQ(sqlite3_prepare_v2(db, "PRAGMA compress_codec;", -1, &stmt, nullptr), SQLITE_OK);
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        codec = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+    return codec;
+}
+
+/**
+ * @tc.name: CompressTest020
+ * @tc.desc: Test to switch the codec of an empty compressed db by pragma
+ * @tc.type: FUNC
+ */
+HWTEST_F(SQLiteCompressTest, CompressTest020, TestSize.Level0)
+{
+    if (!IsSupportPageCompress()) {
+        GTEST_SKIP() << "Current testcase is not compatible";
+    }
+    /**
+     * @tc.steps: step1. Switch the codec of an empty compressed db to brotli and back to zstd
+     * @tc.expected: step1. Execute successfully, both codecs are loaded in one process
+     */
+    std::string dbPath = TEST_DIR "/test020_compress.db";
+    sqlite3 *db = nullptr;
+    EXPECT_EQ(sqlite3_open_v2(dbPath.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, "compressvfs"),
+        SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(db, "PRAGMA compress_codec=brotli;", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(UtGetCompressCodec(db), "brotli");
+    EXPECT_EQ(sqlite3_exec(db, "PRAGMA compress_codec=zstd;", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(UtGetCompressCodec(db), "zstd");
+    EXPECT_EQ(sqlite3_exec(db, "PRAGMA compress_codec=brotli;", nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3_close_v2(db);
+    /**
+     * @tc.steps: step2. Write data into the db, then switch the codec again
+     * @tc.expected: step2. The data is compressed by brotli, the codec can not be changed any more
+     */
+    UtPresetDb(dbPath, "compressvfs");
+    EXPECT_EQ(sqlite3_open_v2(dbPath.c_str(), &db, SQLITE_OPEN_READWRITE, "compressvfs"), SQLITE_OK);
+    EXPECT_EQ(UtGetCompressCodec(db), "brotli");
+    EXPECT_EQ(sqlite3_exec(db, "PRAGMA compress_codec=zstd;", nullptr, nullptr, nullptr), SQLITE_ERROR);
+    sqlite3_close_v2(db);
+    UtCheckPresetDb(dbPath, "compressvfs");
+}
+
+static int UtGetPhoneCount(sqlite3 *db)
+{
+    sqlite3_stmt *stmt = nullptr;
+    int count = -1;
+    EXPECT_EQ(sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM phone;", -1, &stmt, nullptr), SQLITE_OK);
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        count = sqlite3_column_int(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return count;
+}
+
+/**
+ * @tc.name: CompressTest021
+ * @tc.desc: Test to convert in steps in wal mode while the source is written between the steps
+ * @tc.type: FUNC
+ */
+HWTEST_F(SQLiteCompressTest, CompressTest021, TestSize.Level0)
+{
+    if (!IsSupportPageCompress()) {
+        GTEST_SKIP() << "Current testcase is not compatible";
+    }
+    /**
+     * @tc.steps: step1. Convert the plain db in wal mode to compressed db, 2 pages per step, update the
+     *     phone table written before the high-water mark and insert a row between every two steps
+     * @tc.expected: step1. The conversion goes on from the high-water mark instead of restarting
+     */
+    EXPECT_EQ(sqlite3_exec(db_, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr), SQLITE_OK);
+    std::string compressPath = TEST_DIR "/test021_compress.db";
+    sqlite3_compressdb_convert *convert = sqlite3_compressdb_convert_init(db_, compressPath.c_str(),
+        COMPRESSDB_CONVERT_COMPRESS);
+    ASSERT_TRUE(convert != nullptr);
+    EXPECT_EQ(sqlite3_compressdb_convert_step(convert, 2), SQLITE_OK);  // 2 means the page count of one step
+    int maxStep = sqlite3_compressdb_convert_remaining(convert) / 2 + 20;  // 20 more steps for the new pages
+    int nStep = 0;
+    int rc = SQLITE_OK;
+    for (int i = TEST_PRESET_DATA_COUNT + 1; rc == SQLITE_OK && nStep < maxStep; i++, nStep++) {
+        std::string dml = "UPDATE phone SET price=price+1 WHERE id=1;INSERT INTO phone(id, name) VALUES(" +
+            std::to_string(i) + ", 'new phone');";
+        EXPECT_EQ(sqlite3_exec(db_, dml.c_str(), nullptr, nullptr, nullptr), SQLITE_OK);
+        rc = sqlite3_compressdb_convert_step(convert, 2);  // 2 means the page count of one step
+    }
+    EXPECT_EQ(rc, SQLITE_DONE);
+    EXPECT_LT(nStep, maxStep);
+    EXPECT_EQ(sqlite3_compressdb_convert_finish(convert), SQLITE_OK);
+    sqlite3 *compressDb = nullptr;
+    EXPECT_EQ(sqlite3_open_v2(compressPath.c_str(), &compressDb, SQLITE_OPEN_READWRITE, "compressvfs"), SQLITE_OK);
+    EXPECT_EQ(UtGetPhoneCount(compressDb), UtGetPhoneCount(db_));
+    sqlite3_close_v2(compressDb);
+    /**
+     * @tc.steps: step2. Convert the compressed db back to plain db in steps, the OutterDB in wal mode
+     * @tc.expected: step2. The commit of each step is not taken as a change, so the conversion finishes
+     */
+    std::string plainPath = TEST_DIR "/test021_plain.db";
+    EXPECT_EQ(sqlite3_open_v2(compressPath.c_str(), &compressDb, SQLITE_OPEN_READWRITE, nullptr), SQLITE_OK);
+    EXPECT_EQ(sqlite3_exec(compressDb, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr), SQLITE_OK);
+    convert = sqlite3_compressdb_convert_init(compressDb, plainPath.c_str(), COMPRESSDB_CONVERT_DECOMPRESS);
+    ASSERT_TRUE(convert != nullptr);
+    EXPECT_EQ(sqlite3_compressdb_convert_step(convert, 2), SQLITE_OK);  // 2 means the page count of one step
+    maxStep = sqlite3_compressdb_convert_remaining(convert) / 2 + 2;  // 2 more steps for the last partial one
+    for (nStep = 0; (rc = sqlite3_compressdb_convert_step(convert, 2)) == SQLITE_OK && nStep < maxStep; nStep++) {
+    }
+    EXPECT_EQ(rc, SQLITE_DONE);
+    EXPECT_EQ(sqlite3_compressdb_convert_finish(convert), SQLITE_OK);
+    sqlite3_close_v2(compressDb);
+    sqlite3 *plainDb = nullptr;
+    EXPECT_EQ(sqlite3_open_v2(plainPath.c_str(), &plainDb, SQLITE_OPEN_READWRITE, nullptr), SQLITE_OK);
+    EXPECT_EQ(UtGetPhoneCount(plainDb), UtGetPhoneCount(db_));
+    sqlite3_close_v2(plainDb);
+}
+
 }  // namespace Test